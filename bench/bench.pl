@@ -0,0 +1,491 @@
+#!/usr/bin/env perl
+
+=head1 NAME
+
+bench.pl - end-to-end throughput and scaling benchmarks.
+
+=head1 SYNOPSIS
+
+    bench/bench.pl [options] > results.csv
+
+    bench/bench.pl --models SIR,Spatial --nthreads 1,4,16 --nparticles 4096
+
+=head1 DESCRIPTION
+
+Runs the C<filter> or C<sample> client on a set of reference models, across
+numbers of threads, numbers of particles, and with SSE on and off, and
+reports throughput, parallel efficiency and peak memory use, so that
+performance can be compared between machines and releases.
+
+The reference models, in the same directory as this script, are:
+
+=over 4
+
+=item F<LinearGaussian.bi>
+
+a linear-Gaussian state-space model, where cost is dominated by
+resampling and per-particle overheads,
+
+=item F<SIR.bi>
+
+a stochastic SIR epidemic model with binomial transitions and Poisson
+observations,
+
+=item F<Stiff.bi>
+
+a moderately stiff ordinary differential equation model, where cost is
+dominated by the adaptive step size integrator, and
+
+=item F<Spatial.bi>
+
+a high-dimensional spatial model, declared with C<dim>, with spatially
+sparse observations given by a C<coord> variable.
+
+=back
+
+For each model, a data set is first simulated with C<libbi sample --target
+joint>, and for the spatial model thinned to a random subset of sites at
+each time. Data sets are kept in the F<data> subdirectory of the working
+directory and reused by later runs. Each combination of options is then
+built once, so that build time is excluded, and run C<--reps> times.
+
+Results are written to standard output as comma-separated values, one line
+per combination, with columns:
+
+=over 4
+
+=item C<model>, C<client>, C<sse>, C<nthreads>, C<nparticles>
+
+The combination.
+
+=item C<steps>
+
+Number of observation times.
+
+=item C<wall_s>
+
+Median real time of the runs, in seconds, including start-up.
+
+=item C<clock_s>
+
+Median time reported by the client for the filter itself, in seconds, or
+C<NA> if not reported, as for C<sample>.
+
+=item C<throughput>
+
+Particle steps per second, using C<clock_s> if available and C<wall_s>
+otherwise. For C<sample>, each sample counts a full pass of the filter.
+
+=item C<speedup>, C<efficiency>
+
+Speedup and parallel efficiency relative to the smallest number of threads
+for the same model, SSE setting and number of particles.
+
+=item C<peak_rss_kb>
+
+Largest peak resident set size over the runs, in kilobytes, or C<NA> if GNU
+time is not available at F</usr/bin/time>.
+
+=back
+
+The NetCDF utilities C<ncdump> and C<ncgen> must be on the path.
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--models> (default C<LinearGaussian,SIR,Stiff,Spatial>)
+
+Comma-separated list of models to run.
+
+=item C<--client> (default C<filter>)
+
+Client to run, C<filter> or C<sample>.
+
+=item C<--nthreads> (default powers of two up to the number of processors)
+
+Comma-separated list of numbers of threads.
+
+=item C<--nparticles> (default C<256,1024,4096>)
+
+Comma-separated list of numbers of particles.
+
+=item C<--sse> (default C<0,1>)
+
+Comma-separated list of SSE settings, 0 for off and 1 for on.
+
+=item C<--nsamples> (default 10)
+
+Number of samples, for C<sample>.
+
+=item C<--reps> (default 3)
+
+Number of runs of each combination.
+
+=item C<--seed> (default 1)
+
+Pseudorandom number generator seed, the same for all runs.
+
+=item C<--libbi> (default F<../script/libbi> relative to this script)
+
+The C<libbi> script.
+
+=item C<--work-dir> (default F<work> relative to this script)
+
+Working directory for builds, data and output.
+
+=item C<--build-args> (default none)
+
+Additional build options for all runs, e.g. C<'--enable-avx'>.
+
+=back
+
+=cut
+
+use strict;
+use warnings;
+
+use FindBin qw($Bin);
+use Getopt::Long;
+use Pod::Usage;
+use Time::HiRes qw(time);
+use File::Path qw(mkpath);
+use File::Copy;
+use File::Spec;
+
+# reference models, with observation schedules
+my %MODELS = (
+    'LinearGaussian' => { 'end-time' => 100, 'noutputs' => 100 },
+    'SIR' => { 'end-time' => 100, 'noutputs' => 100 },
+    'Stiff' => { 'end-time' => 20, 'noutputs' => 20 },
+    'Spatial' => { 'end-time' => 10, 'noutputs' => 100, 'obs' => 'y',
+        'sparse' => 0.25 },
+);
+
+# options
+my $models = 'LinearGaussian,SIR,Stiff,Spatial';
+my $client = 'filter';
+my $nthreads = join(',', default_nthreads());
+my $nparticles = '256,1024,4096';
+my $sse = '0,1';
+my $nsamples = 10;
+my $reps = 3;
+my $seed = 1;
+my $libbi = File::Spec->catfile($Bin, File::Spec->updir, 'script', 'libbi');
+my $workdir = File::Spec->catdir($Bin, 'work');
+my $buildargs = '';
+my $help = 0;
+
+GetOptions(
+    'models=s' => \$models,
+    'client=s' => \$client,
+    'nthreads=s' => \$nthreads,
+    'nparticles=s' => \$nparticles,
+    'sse=s' => \$sse,
+    'nsamples=i' => \$nsamples,
+    'reps=i' => \$reps,
+    'seed=i' => \$seed,
+    'libbi=s' => \$libbi,
+    'work-dir=s' => \$workdir,
+    'build-args=s' => \$buildargs,
+    'help' => \$help) || pod2usage(2);
+pod2usage(0) if $help;
+
+die("--client must be filter or sample\n") unless $client =~ /^(filter|sample)$/;
+foreach my $model (split(/,/, $models)) {
+    die("unknown model $model\n") unless exists $MODELS{$model};
+}
+foreach my $tool ('ncdump', 'ncgen') {
+    die("$tool not found on path\n") if system("$tool -h >/dev/null 2>&1") == -1;
+}
+my $gnutime = -x '/usr/bin/time' && system('/usr/bin/time -f %M true >/dev/null 2>&1') == 0;
+
+$libbi = File::Spec->rel2abs($libbi);
+mkpath(File::Spec->catdir($workdir, 'data'));
+mkpath(File::Spec->catdir($workdir, 'results'));
+chdir($workdir) || die("could not change to $workdir\n");
+
+print join(',', qw(model client sse nthreads nparticles steps wall_s clock_s
+    throughput speedup efficiency peak_rss_kb)) . "\n";
+
+foreach my $model (split(/,/, $models)) {
+    my $config = $MODELS{$model};
+
+    # model file must be in the working directory, as the build directory is
+    # named after it
+    my $modelfile = "$model.bi";
+    copy(File::Spec->catfile($Bin, $modelfile), $modelfile) ||
+        die("could not copy $modelfile\n");
+    my $obsfile = File::Spec->catfile('data', "$model.nc");
+    my $outfile = File::Spec->catfile('results', "$model.nc");
+
+    if (!-e $obsfile) {
+        generate($model, $modelfile, $obsfile, $config);
+    }
+    my $steps = count_times($obsfile, $config);
+
+    foreach my $s (split(/,/, $sse)) {
+        my @args = ($client, '--model-file', $modelfile,
+            '--obs-file', $obsfile,
+            '--end-time', $config->{'end-time'},
+            '--seed', $seed,
+            '--output-file', $outfile,
+            $s ? '--enable-sse' : '--disable-sse',
+            split(' ', $buildargs));
+        if ($client eq 'sample') {
+            push(@args, '--target', 'posterior', '--nsamples', $nsamples);
+        }
+
+        # build once, outside of timing
+        report("Building $model with SSE " . ($s ? 'on' : 'off') . "...");
+        run($libbi, @args, '--dry-run');
+
+        foreach my $P (split(/,/, $nparticles)) {
+            my @rows;
+            foreach my $N (split(/,/, $nthreads)) {
+                report("Running $model with $N threads and $P particles...");
+                my (@walls, @clocks, $rss);
+                for (my $rep = 0; $rep < $reps; ++$rep) {
+                    my ($wall, $peak) = timed_run($gnutime, $libbi, @args,
+                        '--nparticles', $P, '--nthreads', $N,
+                        '--dry-parse', '--dry-gen', '--dry-build');
+                    push(@walls, $wall);
+                    my $clock = read_clock($outfile);
+                    push(@clocks, $clock) if defined $clock;
+                    $rss = $peak if defined $peak && (!defined $rss || $peak > $rss);
+                }
+                my $wall = median(@walls);
+                my $clock = @clocks ? median(@clocks) : undef;
+                my $t = defined $clock ? $clock : $wall;
+                my $passes = ($client eq 'sample') ? $nsamples : 1;
+                push(@rows, {
+                    'nthreads' => $N,
+                    'wall' => $wall,
+                    'clock' => $clock,
+                    'time' => $t,
+                    'throughput' => $P*$steps*$passes/$t,
+                    'rss' => $rss
+                });
+            }
+
+            # scaling relative to smallest number of threads
+            my ($base) = sort { $a->{nthreads} <=> $b->{nthreads} } @rows;
+            foreach my $row (@rows) {
+                my $speedup = $base->{time}/$row->{time};
+                my $efficiency = $speedup*$base->{nthreads}/$row->{nthreads};
+                print join(',', $model, $client, $s, $row->{nthreads}, $P,
+                    $steps, fmt($row->{wall}), fmt($row->{clock}),
+                    fmt($row->{throughput}), fmt($speedup), fmt($efficiency),
+                    defined $row->{rss} ? $row->{rss} : 'NA') . "\n";
+            }
+        }
+    }
+}
+
+=head1 FUNCTIONS
+
+=over 4
+
+=item B<generate>(I<model>, I<modelfile>, I<obsfile>, I<config>)
+
+Simulate data set for model.
+
+=cut
+sub generate {
+    my ($model, $modelfile, $obsfile, $config) = @_;
+    my $jointfile = File::Spec->catfile('data', "${model}_joint.nc");
+
+    report("Simulating data for $model...");
+    run($libbi, 'sample', '--target', 'joint', '--model-file', $modelfile,
+        '--nsamples', 1, '--end-time', $config->{'end-time'},
+        '--noutputs', $config->{'noutputs'}, '--seed', $seed,
+        '--output-file', $jointfile, split(' ', $buildargs));
+
+    if ($config->{sparse}) {
+        thin($jointfile, $obsfile, $config->{obs}, $config->{sparse});
+    } else {
+        rename($jointfile, $obsfile) || die("could not rename $jointfile\n");
+    }
+}
+
+=item B<thin>(I<jointfile>, I<obsfile>, I<name>, I<frac>)
+
+Thin a dense vector observation variable to a random subset of sites at
+each time, with a coordinate variable, as a spatially sparse data set.
+
+=cut
+sub thin {
+    my ($jointfile, $obsfile, $name, $frac) = @_;
+
+    my @ts = read_var($jointfile, 'time');
+    my @ys = read_var($jointfile, $name);
+    my $n = scalar(@ys)/scalar(@ts);
+    my (@time, @coord, @y);
+
+    srand($seed);
+    for (my $k = 0; $k < @ts; ++$k) {
+        my @sites = grep { rand() < $frac } (0..$n - 1);
+        @sites = (int(rand($n))) unless @sites;
+        foreach my $i (@sites) {
+            push(@time, $ts[$k]);
+            push(@coord, $i);
+            push(@y, $ys[$k*$n + $i]);
+        }
+    }
+
+    my $cdlfile = "$obsfile.cdl";
+    open(my $fh, '>', $cdlfile) || die("could not write $cdlfile\n");
+    print $fh "netcdf obs {\n";
+    print $fh "dimensions:\n";
+    print $fh "  nr = " . scalar(@time) . " ;\n";
+    print $fh "variables:\n";
+    print $fh "  double time_$name(nr) ;\n";
+    print $fh "  int coord_$name(nr) ;\n";
+    print $fh "  double $name(nr) ;\n";
+    print $fh "data:\n";
+    print $fh "  time_$name = " . join(', ', @time) . " ;\n";
+    print $fh "  coord_$name = " . join(', ', @coord) . " ;\n";
+    print $fh "  $name = " . join(', ', @y) . " ;\n";
+    print $fh "}\n";
+    close($fh);
+
+    run('ncgen', '-o', $obsfile, $cdlfile);
+    unlink($cdlfile);
+}
+
+=item B<count_times>(I<obsfile>, I<config>)
+
+Count distinct observation times in data set.
+
+=cut
+sub count_times {
+    my ($obsfile, $config) = @_;
+    my $name = $config->{sparse} ? 'time_' . $config->{obs} : 'time';
+    my %ts = map { $_ => 1 } read_var($obsfile, $name);
+    return scalar(keys %ts);
+}
+
+=item B<read_var>(I<file>, I<name>)
+
+Read values of variable from NetCDF file, with C<ncdump>.
+
+=cut
+sub read_var {
+    my ($file, $name) = @_;
+    my $out = `ncdump -v $name $file`;
+    die("could not read $name from $file\n") if $? != 0;
+    $out =~ /^data:.*?^\s*\Q$name\E\s*=(.*?);/ms ||
+        die("could not find $name in $file\n");
+    return grep { $_ ne '' } split(/[\s,]+/, $1);
+}
+
+=item B<read_clock>(I<file>)
+
+Read time reported by the client in output file, in seconds, or undef if
+not available.
+
+=cut
+sub read_clock {
+    my $file = shift;
+    my $out = `ncdump -v clock $file 2>/dev/null`;
+    if ($? == 0 && $out =~ /^\s*clock\s*=\s*(\d+)\s*;/m) {
+        return $1/1.0e6;
+    }
+    return undef;
+}
+
+=item B<run>(I<cmd>, I<args>...)
+
+Run command, dying on failure.
+
+=cut
+sub run {
+    system(@_) == 0 || die("command failed: " . join(' ', @_) . "\n");
+}
+
+=item B<timed_run>(I<gnutime>, I<cmd>, I<args>...)
+
+Run command, dying on failure, and return its real time in seconds and
+peak resident set size in kilobytes, the latter undef if I<gnutime> is
+false.
+
+=cut
+sub timed_run {
+    my $gnutime = shift;
+    my @cmd = @_;
+    my $rssfile = File::Spec->catfile('results', 'rss.txt');
+    my $rss;
+
+    if ($gnutime) {
+        unshift(@cmd, '/usr/bin/time', '-f', '%M', '-o', $rssfile);
+    }
+    my $start = time;
+    run(@cmd);
+    my $wall = time - $start;
+    if ($gnutime && open(my $fh, '<', $rssfile)) {
+        while (my $line = <$fh>) {
+            $rss = $1 if $line =~ /^(\d+)\s*$/;
+        }
+        close($fh);
+    }
+    return ($wall, $rss);
+}
+
+=item B<median>(I<values>...)
+
+Median of values.
+
+=cut
+sub median {
+    my @xs = sort { $a <=> $b } @_;
+    my $n = scalar(@xs);
+    return ($n % 2) ? $xs[$n/2] : 0.5*($xs[$n/2 - 1] + $xs[$n/2]);
+}
+
+=item B<fmt>(I<value>)
+
+Format value for output.
+
+=cut
+sub fmt {
+    my $x = shift;
+    return defined $x ? sprintf('%.6g', $x) : 'NA';
+}
+
+=item B<default_nthreads>
+
+Powers of two up to the number of processors.
+
+=cut
+sub default_nthreads {
+    my $ncpus = 1;
+    if (open(my $fh, '<', '/proc/cpuinfo')) {
+        $ncpus = scalar(grep { /^processor\s*:/ } <$fh>) || 1;
+        close($fh);
+    } elsif (`sysctl -n hw.ncpu 2>/dev/null` =~ /(\d+)/) {
+        $ncpus = $1;
+    }
+    my @ns;
+    for (my $n = 1; $n <= $ncpus; $n *= 2) {
+        push(@ns, $n);
+    }
+    return @ns;
+}
+
+=item B<report>(I<msg>)
+
+Report progress to stderr.
+
+=cut
+sub report {
+    my $msg = shift;
+    print STDERR "$msg\n";
+}
+
+=back
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=cut
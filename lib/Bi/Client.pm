@@ -49,6 +49,27 @@ Run within the C<cuda-gdb> debugger.
 
 Run within C<cuda-memcheck>.
 
+=item C<--with-thread-binding> (default off)
+
+Bind each OpenMP thread to a core, by setting C<OMP_PROC_BIND=close> and
+C<OMP_PLACES=cores> in the environment of the program, where not already
+set. Particles are statically partitioned between threads, and state is
+first touched by the thread that owns it, so that on machines with
+multiple memory nodes (e.g. multiple sockets), binding keeps each thread
+on the memory node that holds its particles. Do not use with multiple
+processes per node under C<--enable-mpi> unless C<mpirun> binds processes
+to disjoint sets of cores.
+
+=item C<--with-timing> (default off)
+
+Record the execution time of each phase of the run (updates of inputs and
+observations, transition, observation densities, reductions, resampling,
+output and waiting on other processes) in the C<clock_*> variables of the
+output file, and report it on C<stderr> after each progress line of the
+samplers. Device execution is synchronized at each phase boundary so that
+times are attributed correctly, which may slow GPU runs. When off, the
+C<clock_*> variables are zero.
+
 =item C<--gperftools-file> (default automatic)
 
 Output file to use under C<--enable-gperftools>. The default is
@@ -211,6 +232,11 @@ our @EXEC_OPTIONS = (
       name => 'with-cuda-memcheck',
       type => 'bool',
       default => 0
+    },
+    {
+      name => 'with-thread-binding',
+      type => 'bool',
+      default => 0
     }
 );
 
@@ -276,6 +302,11 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => 0
     },
+    {
+      name => 'with-timing',
+      type => 'bool',
+      default => 0
+    },
     {
       name => 'gperftools-file',
       type => 'string',
@@ -704,6 +735,10 @@ sub exec {
     } else {
         unshift(@argv, "\"$binary\"");
     }
+    if ($self->get_named_exec_arg('with-thread-binding')) {
+        $ENV{'OMP_PROC_BIND'} = 'close' unless exists $ENV{'OMP_PROC_BIND'};
+        $ENV{'OMP_PLACES'} = 'cores' unless exists $ENV{'OMP_PLACES'};
+    }
     if ($self->get_named_arg('with-mpi')) {
         my $np = '';
         if ($self->is_named_arg('mpi-np')) {
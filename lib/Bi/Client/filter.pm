@@ -44,6 +44,47 @@ the state will be output at time C<T*k/K>.
 
 Output at observation times in addition to dense output times.
 
+=item C<--obs-files>
+
+Comma-separated list of files from which to read observations, in place of
+C<--obs-file>, to filter several datasets in one run. The model is
+constructed, and inputs from C<--input-file> read, only once, and each
+dataset is then filtered in turn. Output for the I<k>th file in the list
+(counting from zero) is written to C<--output-file> with the suffix
+C<.>I<k>. Only available for the C<filter> command.
+
+=item C<--with-stream> (default 0)
+
+Filter observations as they arrive. After filtering those observations
+already in C<--obs-file>, keep polling the file for observations appended to
+it, and filter only the new steps, without restarting. The filter is first
+run to the time of the last observation, and C<--end-time>, if greater than
+C<--start-time>, gives the time at which to stop. Output is written after
+each update, and the time, log-likelihood increment and cumulative
+log-likelihood at each new observation are printed to standard output, one
+line per observation. Observations must be appended to the file in time
+order, and the writer should close or synchronise the file after each
+append. Observations appended at the time of the last observation already
+filtered are ignored, so all observations at one time should be appended
+together. Filtering does not start until there is at least one observation
+at or after C<--start-time>. Each update scans only the records appended
+to C<--obs-file>, extends the schedule from its last time, and writes only
+the new output records, so that its cost depends on the number of new
+observations rather than on the number already filtered. Implies
+C<--with-output-at-obs>, requires C<--noutputs 0> and C<--nbridges 0>, and
+is not supported by the C<adaptive> and C<kalman> filters. Only available
+for the C<filter> command.
+
+=item C<--stream-interval> (default 1.0)
+
+Interval, in seconds, at which to poll C<--obs-file> for new observations
+when C<--with-stream> is used.
+
+=item C<--stream-timeout> (default 0.0)
+
+Stop when no new observations have arrived in C<--obs-file> for this many
+seconds when C<--with-stream> is used. Zero to wait indefinitely.
+
 =item C<--filter> (default C<bootstrap>)
 
 The type of filter to use; one of:
@@ -69,6 +110,19 @@ Particle filter with intermediate bridging weights, as described in
 Del Moral & Murray (2014). Bridging weights are assigned according to the
 L<bridge> top-level block.
 
+=item C<block>
+
+Block particle filter (Rebeschini & van Handel, 2015), for spatial models of
+high dimension. See L</Block particle filter-specific options> below.
+
+=item C<enkf>
+
+Ensemble Kalman filter (Evensen 1994), for models of high dimension where
+the particle filter degenerates. The ensemble is propagated as for the
+particle filter, and corrected by linear regression on the observations, so
+that no Jacobian terms are required. See
+L</Ensemble Kalman filter-specific options> below.
+
 =begin comment
 
 =item C<adaptive>
@@ -168,6 +222,52 @@ bridge weighting will occur at time C<T*k/K>.
 
 =back
 
+=head2 Block particle filter-specific options
+
+The following additional options are available when C<--filter> is set to
+C<block>. The filter does not maintain the ancestry of whole particles, so
+that sampled paths are not consistent trajectories. It is suitable for
+filtering and likelihood estimation, not smoothing.
+
+=over 4
+
+=item C<--block-dim>
+
+Name of the dimension along which to partition the state into blocks. Each
+block is weighted only by the observations whose coordinates along this
+dimension fall within it, whether given densely or sparsely with coordinate
+variables, and is resampled independently of the other blocks. Variables and
+observations not indexed by this dimension form one further, global block,
+weighted and resampled in the same way. This option is required.
+
+=item C<--block-size> (default 1)
+
+Number of consecutive indices of C<--block-dim> in each block. Smaller blocks
+need fewer particles, at the cost of greater bias in the estimates near block
+boundaries.
+
+=back
+
+=head2 Ensemble Kalman filter-specific options
+
+The following additional options are available when C<--filter> is set to
+C<enkf>. The number of members of the ensemble is given by
+C<--nparticles>, which should be at least two. Predicted observations are
+obtained by simulating the L<observation> top-level block, which should
+therefore have additive noise of positive variance, uncorrelated between
+observations. The resampling options of the particle filter have no
+effect.
+
+=over 4
+
+=item C<--with-etkf> (default 0)
+
+Correct the ensemble deterministically with the ensemble transform Kalman
+filter (Bishop et al. 2001), rather than stochastically with perturbed
+observations.
+
+=back
+
 =head2 Adaptive particle filter-specific options
 
 The following additional options are available when C<--filter> is set to
@@ -214,7 +314,17 @@ criterion.
 
 =item C<--stopper-block> (default 128)
 
-Number of particles per block.
+Number of particles per correction block. At each time, particles are first
+propagated in one block of the size required at the previous time, then in
+correction blocks of this size until the stopping criterion is met. The
+particles of the block of this size in which the criterion is met are
+discarded.
+
+=item C<--stopper-budget> (default 0.0)
+
+Real time, in seconds, allocated to each step between observations. If
+positive, no further correction blocks are started once it is exceeded, and
+the first block is limited to the size expected to fit within it.
 
 =back
 
@@ -240,6 +350,26 @@ our @CLIENT_OPTIONS = (
       type => 'bool',
       default => 1
     },
+    {
+      name => 'obs-files',
+      type => 'string',
+      default => ''
+    },
+    {
+      name => 'with-stream',
+      type => 'bool',
+      default => 0
+    },
+    {
+      name => 'stream-interval',
+      type => 'float',
+      default => 1.0
+    },
+    {
+      name => 'stream-timeout',
+      type => 'float',
+      default => 0.0
+    },
     {
       name => 'filter',
       type => 'string',
@@ -285,11 +415,31 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => 128
     },
+    {
+      name => 'stopper-budget',
+      type => 'float',
+      default => 0.0
+    },
     {
       name => 'stopper-max',
       type => 'int',
       default => 32768
     },
+    {
+      name => 'block-dim',
+      type => 'string',
+      default => ''
+    },
+    {
+      name => 'block-size',
+      type => 'int',
+      default => 1
+    },
+    {
+      name => 'with-etkf',
+      type => 'bool',
+      default => 0
+    },
     
     # deprecations
     {
@@ -358,6 +508,36 @@ sub process_args {
     my $filter = $self->get_named_arg('filter');
     if ($filter eq 'kalman') {
         $self->set_named_arg('with-transform-extended', 1);
+    } elsif ($filter eq 'block' && $self->get_named_arg('block-dim') eq '') {
+        die("--filter block requires --block-dim\n");
+    }
+    if ($self->get_named_arg('obs-files') ne '') {
+        if (ref($self) ne __PACKAGE__) {
+            die("--obs-files is only supported by the filter command\n");
+        }
+        if ($self->is_named_arg('obs-file') &&
+                $self->get_named_arg('obs-file') ne '') {
+            die("use only one of --obs-file and --obs-files\n");
+        }
+    }
+    if ($self->get_named_arg('with-stream')) {
+        if (ref($self) ne __PACKAGE__) {
+            die("--with-stream is only supported by the filter command\n");
+        }
+        if (!$self->is_named_arg('obs-file') ||
+                $self->get_named_arg('obs-file') eq '') {
+            die("--with-stream requires --obs-file\n");
+        }
+        if ($self->get_named_arg('noutputs') != 0) {
+            die("--with-stream requires --noutputs 0\n");
+        }
+        if ($self->get_named_arg('nbridges') != 0) {
+            die("--with-stream requires --nbridges 0\n");
+        }
+        if ($filter eq 'adaptive' || $filter eq 'kalman') {
+            die("--with-stream is not supported by --filter $filter\n");
+        }
+        $self->set_named_arg('with-output-at-obs', 1);
     }
     $self->{_binary} = 'filter';
 }
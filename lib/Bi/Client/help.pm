@@ -178,6 +178,7 @@ where <command> is one of:
   * package
   * rewrite
   * sample
+  * tune
 
 Type 'libbi help <command>' for help on a particular command. For more
 information on using the help command type 'libbi help help'.
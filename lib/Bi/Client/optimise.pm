@@ -55,8 +55,25 @@ The optimisation method to use; one of:
 
 Nelder-Mead simplex method.
 
+=item C<pnm>
+
+Nelder-Mead simplex method with concurrent evaluation of candidate points,
+and optionally multiple starts. Concurrent evaluations share the one filter,
+so the C<adaptive> and C<block> filters, which keep state between calls, are
+not supported.
+
 =back
 
+=item C<--with-crn> (default off)
+
+Use common random numbers. The filter draws the same random numbers for
+every evaluation of the objective, so that its estimate of the likelihood
+is a deterministic function of the parameters, rather than noisy. Particles
+are also sorted along a Hilbert curve before resampling, so that this
+function is close to continuous. This typically permits the simplex to
+converge in far fewer steps, at the cost of optimising one realisation of
+the estimator; increase C<--nparticles> to reduce the bias this introduces.
+
 =back
 
 =head2 Nelder-mead simplex method-specific options
@@ -77,6 +94,21 @@ Maximum number of steps to take.
 
 =back
 
+=head2 Parallel Nelder-mead simplex method-specific options
+
+=over 4
+
+=item C<--nstarts> (default 1)
+
+Number of starts. The first begins from C<--init-file>, if given, and the
+remainder from the prior. Each step evaluates the reflection, expansion and
+contraction points of all starts concurrently, using one thread per
+evaluation, so that up to four times C<--nstarts> threads are used. Under
+C<--enable-mpi>, starts are distributed between processes, each with its
+own output file.
+
+=back
+
 =cut
 our @CLIENT_OPTIONS = (
     {
@@ -113,6 +145,16 @@ our @CLIENT_OPTIONS = (
       name => 'stop-steps',
       type => 'int',
       default => 100
+    },
+    {
+      name => 'nstarts',
+      type => 'int',
+      default => 1
+    },
+    {
+      name => 'with-crn',
+      type => 'bool',
+      default => 0
     }
 );
 
@@ -127,6 +169,11 @@ sub process_args {
     my $self = shift;
 
     $self->Bi::Client::filter::process_args(@_);   
+    my $filter = $self->get_named_arg('filter');
+    if ($self->get_named_arg('optimiser') eq 'pnm' &&
+            ($filter eq 'adaptive' || $filter eq 'block')) {
+        die("--optimiser pnm does not support --filter $filter\n");
+    }
     $self->{_binary} = 'optimise';
 }
 
@@ -72,11 +72,23 @@ Marginal Metropolis-Hastings (Andrieu, Doucet & Holenstein, 2010).
 =item C<sir> or (deprecated) C<smc2>
 
 Marginal sequential importance resampling (Chopin, Jacob & Papaspiliopoulos, 2013).
+Move steps are made concurrently, one thread per parameter sample, and share
+the one filter, so the C<adaptive> and C<block> filters, which keep state
+between calls, are not supported.
 
 =item C<sis>
 
 Marginal sequential importance sampling (SIS).
 
+=item C<pt>
+
+Parallel tempering (Geyer, 1991) over marginal Metropolis-Hastings chains.
+
+=item C<if2>
+
+Iterated filtering (IF2; Ionides et al. 2015) for maximum likelihood
+estimation. All iterations are run within the one process.
+
 =back
 
 For MH, the proposal works according to the L<proposal_parameter> top-level
@@ -94,6 +106,80 @@ unless one of the adaptation strategies below is enabled.
 
 Number of samples to draw.
 
+=item C<--checkpoint-file> (default none)
+
+File to which to write checkpoints for C<--sampler mh> and C<--sampler
+sir>. If the file exists when the program starts, sampling resumes from the
+checkpoint that it contains, and the output file is extended rather than
+replaced. The checkpoint must have been written by the same program, with
+the same options and number of threads. With MPI, the rank of each process
+is appended to the file name, as for C<--output-file>.
+
+=item C<--checkpoint-interval> (default 600)
+
+Minimum real time between checkpoints, in seconds.
+
+=back
+
+=head2 MH-specific options
+
+=over 4
+
+=item C<--extend> (default 0)
+
+Extend an existing chain. If the output file exists, the chain resumes from
+the last sample in it, and C<--nsamples> further samples are written after
+those already there, so that burn-in need not be repeated. The file must
+have been written by C<--sampler mh> with C<--nchains 1>, for the same model. With C<--correlation>, the
+random numbers of the last sample are not kept in the file, so its
+likelihood is estimated again with new random numbers on resumption.
+
+=item C<--nchains> (default 1)
+
+Number of independent chains to run. If greater than one, the chains are
+advanced in lockstep within the one process, sharing inputs, observations and
+the output file. C<--nsamples> samples are drawn for each chain, and sample
+I<c> of chain I<k> is written at index I<c> * C<--nchains> + I<k> along the
+C<np> dimension of the output file. The chains are stepped one after
+another, each filter using all threads over its own particles. Only available
+for C<--sampler mh> and C<--sampler pt>.
+
+=item C<--correlation> (default 0.0)
+
+Correlation for correlated pseudo-marginal MH. If positive, the random
+numbers used by the filter are kept with each sample, in blocks between
+observations, and each block is retained for the next proposal with this
+probability, otherwise refreshed. Likelihood estimates for the current and
+proposed parameters are then positively correlated, which permits fewer
+particles for the same mixing. Particles are also sorted along a Hilbert curve
+before resampling, to preserve this correlation. Values close to one, such as
+0.99, are typical. Zero gives the standard sampler. Not supported by the
+C<adaptive> and C<block> filters, which do not assign particles to threads
+the same way on each run.
+
+=item C<--smoothing-lag> (default 0)
+
+Keep the ancestry of particles for only this many observation and output
+times before the end time, for fixed-lag smoothing. Memory used by the filter
+is then bounded by the number of particles and the lag, rather than growing
+with the length of the series, which permits much longer series. State
+trajectories output with each sample follow the sampled particle's ancestry
+for the times within the lag only; at earlier times they hold the fixed-lag
+estimate of the state, taken on one lineage when that time left the lag.
+Zero keeps the full ancestry. Only available with C<--nchains 1> and a
+particle filter.
+
+=item C<--max-temperature> (default 10.0)
+
+For C<--sampler pt>, the temperature of the hottest chain. C<--nchains> gives
+the number of temperatures, spaced geometrically between one and this
+maximum. The chains are stepped concurrently, one per thread, and exchanges
+are proposed between adjacent temperatures after each step. With MPI, each
+process runs C<--nchains> temperatures of the ladder. Only the cold chain is
+output, so that C<--nsamples> samples are written. The chains share the one
+filter, so the C<adaptive> and C<block> filters, which keep state between
+calls, are not supported.
+
 =back
 
 =head2 SIR-specific options
@@ -116,6 +202,13 @@ a random variable dependent on C<--tmoves>.
 The type of resampler to use on parameter particles, see C<--resampler> for
 options.
 
+=item C<--island-resampling> (default 0)
+
+With MPI, resample parameter particles in island mode. Processes exchange
+only the totals of their weights, resample locally, and shift surplus
+particles to neighbouring processes, rather than gathering all weights to
+the root process. Recommended for large numbers of processes.
+
 =item C<--sample-ess-rel> (default 0.5)
 
 Threshold for effective sample size (ESS) resampling trigger. Parameter
@@ -171,6 +264,27 @@ instead.
 
 =back
 
+=head2 IF2-specific options
+
+With C<--sampler if2>, C<--with-transform-iterated-filtering> is enabled
+automatically. Each parameter C<theta> then becomes a state variable that
+follows a Gaussian random walk with standard deviation C<sigma_>, about an
+initial value drawn with mean C<theta_0_> and standard deviation C<tau_>.
+Give starting values for C<theta_0_>, C<tau_> and C<sigma_> in the
+C<--init-file>. C<--nsamples> gives the number of iterations. The swarm of
+parameter particles at the end of each iteration is carried into the next,
+and after each, the mean of the swarm is written to the output file as the
+values of C<theta_0_>, along with the log-likelihood estimate.
+
+=over 4
+
+=item C<--cooling> (default 0.95)
+
+Factor by which the standard deviations C<tau_> and C<sigma_> are multiplied
+after each iteration.
+
+=back
+
 =cut
 our @CLIENT_OPTIONS = (
     {
@@ -188,6 +302,41 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => 1
     },
+    {
+      name => 'checkpoint-file',
+      type => 'string',
+      default => ''
+    },
+    {
+      name => 'checkpoint-interval',
+      type => 'float',
+      default => 600.0
+    },
+    {
+      name => 'nchains',
+      type => 'int',
+      default => 1
+    },
+    {
+      name => 'correlation',
+      type => 'float',
+      default => 0.0
+    },
+    {
+      name => 'extend',
+      type => 'int',
+      default => 0
+    },
+    {
+      name => 'smoothing-lag',
+      type => 'int',
+      default => 0
+    },
+    {
+      name => 'max-temperature',
+      type => 'float',
+      default => 10.0
+    },
     {
       name => 'conditional-pf',
       type => 'int',
@@ -213,6 +362,11 @@ our @CLIENT_OPTIONS = (
       type => 'string',
       default => 'systematic'
     },
+    {
+      name => 'island-resampling',
+      type => 'int',
+      default => 0
+    },
     {
       name => 'sample-ess-rel',
       type => 'float',
@@ -248,6 +402,11 @@ our @CLIENT_OPTIONS = (
       type => 'float',
       default => 0.25
     },
+    {
+      name => 'cooling',
+      type => 'float',
+      default => 0.95
+    },
 );
 
 sub init {
@@ -280,8 +439,39 @@ sub process_args {
     } else {
     	if ($sampler eq 'sir' || $sampler eq 'smc2') {
 	    	$self->set_named_arg('sampler', 'sir'); # standardise name
+	    	if ($filter eq 'adaptive' || $filter eq 'block') {
+	    	    die("--sampler sir does not support --filter $filter\n");
+	    	}
+    	} elsif ($sampler eq 'pt') {
+    	    if ($filter eq 'adaptive' || $filter eq 'block') {
+    	        die("--sampler pt does not support --filter $filter\n");
+    	    }
+    	} elsif ($sampler eq 'if2') {
+    	    if ($filter eq 'kalman' || $filter eq 'enkf') {
+    	        die("--sampler if2 requires a particle filter\n");
+    	    }
+    	    if (!$self->is_named_arg('with-transform-iterated-filtering')) {
+    	        $self->set_named_arg('with-transform-iterated-filtering', 1);
+    	    }
     	}
     }
+    if ($self->get_named_arg('correlation') > 0.0 &&
+            ($filter eq 'adaptive' || $filter eq 'block')) {
+        die("--correlation is not supported by --filter $filter\n");
+    }
+    if ($self->get_named_arg('nchains') > 1 && $sampler ne 'mh' &&
+            $sampler ne 'pmmh' && $sampler ne 'pt') {
+        die("--nchains is only supported by --sampler mh and --sampler pt\n");
+    }
+    if ($self->get_named_arg('smoothing-lag') > 0) {
+        if (($sampler ne 'mh' && $sampler ne 'pmmh') ||
+                $self->get_named_arg('nchains') > 1) {
+            die("--smoothing-lag requires --sampler mh with --nchains 1\n");
+        }
+        if ($filter eq 'kalman') {
+            die("--smoothing-lag requires a particle filter\n");
+        }
+    }
     
     $self->{_binary} = 'sample';
 }
@@ -0,0 +1,150 @@
+=head1 NAME
+
+tune - tune the number of particles, resampling threshold and number of
+threads of a particle filter.
+
+=head1 SYNOPSIS
+
+    libbi tune ...
+
+    libbi tune @config.conf --init-file posterior.nc --tune-file tune.conf
+    libbi sample @config.conf @tune.conf
+
+=head1 DESCRIPTION
+
+Runs short pilot particle filters on the model and data, and chooses the
+number of particles, ESS threshold and number of threads for the particle
+filter within a particle marginal Metropolis-Hastings sampler.
+
+The parameters are fixed for all pilot runs. They are taken from
+C<--init-file> if given, otherwise drawn once from the prior. As the
+efficiency of the sampler depends on the variance of the log-likelihood
+estimator near the posterior mode, an init file holding a posterior sample,
+or a point estimate from L<optimise>, should be given where available.
+
+For each candidate ESS threshold, the number of particles is doubled,
+beginning from C<--nparticles>, until the sample variance of the
+log-likelihood estimates of C<--npilots> pilot runs falls below
+C<--target-var>. The variance is assumed to be inversely proportional to the
+number of particles, from which the smallest number of particles attaining
+the target is interpolated. Each candidate is then timed with each candidate
+number of threads, and the fastest is chosen.
+
+A variance of the log-likelihood estimator of about 1 is near optimal for
+the computational efficiency of particle marginal Metropolis-Hastings (Pitt
+et al. 2012, Doucet et al. 2015), and is the default target.
+
+The result is written to C<--tune-file> as a config file that may be given
+to L<sample>, or L<filter>, with the C<@> syntax. It gives C<--nparticles>,
+C<--ess-rel> and C<--nthreads>, along with C<--enable-sse> or
+C<--disable-sse> as used by C<tune> itself; to compare the two, run C<tune>
+once with each. A summary of the pilot runs is written to standard error,
+including the observation that contributes most to the variance, from the
+log-likelihood increments of each run.
+
+=head1 INHERITS
+
+L<Bi::Client::filter>
+
+=cut
+
+package Bi::Client::tune;
+
+use parent 'Bi::Client::filter';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+The C<tune> command inherits all options from L<filter>, and permits the
+following additional options:
+
+=over 4
+
+=item C<--tune-file> (default C<'tune.conf'>)
+
+Config file to which to write the chosen options.
+
+=item C<--npilots> (default 16)
+
+Number of pilot runs for each candidate.
+
+=item C<--nparticles-max> (default 65536)
+
+Maximum number of particles to try.
+
+=item C<--ess-rels> (default C<'0.25,0.5,0.75,1.0'>)
+
+Comma-separated list of candidate ESS thresholds, as for C<--ess-rel>.
+
+=item C<--target-var> (default 1.0)
+
+Target variance of the log-likelihood estimator.
+
+=item C<--with-tune-threads> (default 1)
+
+Try powers of two for the number of threads, up to C<--nthreads> or the
+OpenMP default. Otherwise use C<--nthreads> only.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'tune-file',
+      type => 'string',
+      default => 'tune.conf'
+    },
+    {
+      name => 'npilots',
+      type => 'int',
+      default => 16
+    },
+    {
+      name => 'nparticles-max',
+      type => 'int',
+      default => 65536
+    },
+    {
+      name => 'ess-rels',
+      type => 'string',
+      default => '0.25,0.5,0.75,1.0'
+    },
+    {
+      name => 'target-var',
+      type => 'float',
+      default => 1.0
+    },
+    {
+      name => 'with-tune-threads',
+      type => 'bool',
+      default => 1
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    Bi::Client::filter::init($self);
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+sub process_args {
+    my $self = shift;
+
+    $self->Bi::Client::filter::process_args(@_);
+
+    my $filter = $self->get_named_arg('filter');
+    if ($filter eq 'kalman' || $filter eq 'adaptive') {
+        die("tune supports particle filters with a fixed number of particles only\n");
+    }
+
+    $self->{_binary} = 'tune';
+}
+
+1;
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
@@ -0,0 +1,93 @@
+=head1 NAME
+
+test_ancestry - test fixed-lag truncation of the ancestry cache.
+
+=head1 SYNOPSIS
+
+    libbi test_ancestry ...
+
+=head1 DESCRIPTION
+
+Writes the same random ancestry to an ancestry cache that keeps the full
+ancestry and to one with a lag set, then checks that the lagged cache never
+holds more nodes than the number of particles times the lag plus one, that
+the paths it reads match those of the full cache for the times within the
+lag, and that earlier times hold fixed-lag estimates rather than NaN. Exits
+with an error on the first failed check.
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=cut
+
+package Bi::Test::test_ancestry;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--Ps> (default 5)
+
+Number of numbers of particles to use. Numbers are powers of two, from 16
+upward.
+
+=item C<--ndims> (default 4)
+
+Number of variables.
+
+=item C<--ntimes> (default 100)
+
+Number of times.
+
+=item C<--lag> (default 8)
+
+Lag of the lagged cache.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'Ps',
+      type => 'int',
+      default => 5
+    },
+    {
+      name => 'ndims',
+      type => 'int',
+      default => 4
+    },
+    {
+      name => 'ntimes',
+      type => 'int',
+      default => 100
+    },
+    {
+      name => 'lag',
+      type => 'int',
+      default => 8
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    $self->{_binary} = 'test_ancestry';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+sub needs_model {
+    return 0;
+}
+
+1;
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
@@ -0,0 +1,183 @@
+=head1 NAME
+
+test_benchmark - benchmark resamplers, random number generation, reductions,
+batched linear algebra, ancestry caching and input/output.
+
+=head1 SYNOPSIS
+
+    libbi test_benchmark ...
+
+    libbi test_benchmark --benchmarks resampler,reduce --Ps 12 > results.csv
+
+    libbi test_benchmark --model-file Model.bi --benchmarks io
+
+=head1 DESCRIPTION
+
+Times core components on the host, independently of any particular method,
+so that performance can be compared between machines and releases. Results
+are written to standard output as comma-separated values, one line per
+benchmark and problem size, with columns:
+
+=over 4
+
+=item C<benchmark>
+
+Name of the benchmark.
+
+=item C<P>
+
+Problem size: number of particles, variates or matrices.
+
+=item C<param>
+
+Second parameter of the benchmark: the weight skew for resamplers and
+reductions, the distribution parameter for random number generation, the
+matrix size for batched linear algebra, and the number of times for
+ancestry caching and input/output.
+
+=item C<reps>
+
+Number of repetitions.
+
+=item C<mean_us>, C<sd_us>, C<min_us>, C<median_us>, C<max_us>
+
+Summary of the time taken by each repetition, in microseconds.
+
+=back
+
+All random number generators are reseeded with C<--seed> before each
+benchmark, so that the same seed gives the same inputs, whichever subset of
+benchmarks is run.
+
+The input/output benchmarks require a model, given with C<--model-file>, and
+are skipped otherwise. They write C<--output-file>, if given, or
+F<test_benchmark.nc> otherwise, then read it back.
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=cut
+
+package Bi::Test::test_benchmark;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--benchmarks> (default C<'all'>)
+
+Comma-separated list of the benchmarks to run, from:
+
+=over 8
+
+=item C<'resampler'>
+
+for the stratified, systematic, multinomial, Metropolis and rejection
+resamplers,
+
+=item C<'reduce'>
+
+for the effective sample size and log-sum-exp reductions of log-weights,
+
+=item C<'random'>
+
+for uniform, Gaussian, gamma and beta vector generators,
+
+=item C<'multi'>
+
+for batched matrix-vector and matrix-matrix multiplication, Cholesky
+factorisation and triangular solve,
+
+=item C<'ancestry'>
+
+for writes to, and path reads from, the ancestry cache, or
+
+=item C<'io'>
+
+for writes and reads of simulator output files, and reads of them as input
+files.
+
+=back
+
+or C<'all'> for all of these.
+
+=item C<--Zs> (default 5)
+
+Number of weight skews to use for the resampler and reduction benchmarks.
+
+=item C<--Ps> (default 10)
+
+Number of problem sizes to use. Sizes are powers of two, from 16 upward.
+
+=item C<--reps> (default 100)
+
+Number of repetitions of each benchmark for each combination of
+parameters.
+
+=item C<--ndims> (default 8)
+
+Size of matrices in the batched linear algebra benchmarks, and number of
+variables in the ancestry cache benchmarks.
+
+=item C<--ntimes> (default 100)
+
+Number of times in the ancestry cache and input/output benchmarks.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'benchmarks',
+      type => 'string',
+      default => 'all'
+    },
+    {
+      name => 'Zs',
+      type => 'int',
+      default => 5
+    },
+    {
+      name => 'Ps',
+      type => 'int',
+      default => 10
+    },
+    {
+      name => 'reps',
+      type => 'int',
+      default => 100
+    },
+    {
+      name => 'ndims',
+      type => 'int',
+      default => 8
+    },
+    {
+      name => 'ntimes',
+      type => 'int',
+      default => 100
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    $self->{_binary} = 'test_benchmark';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+sub needs_model {
+    return 0;
+}
+
+1;
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
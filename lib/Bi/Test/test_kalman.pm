@@ -0,0 +1,79 @@
+=head1 NAME
+
+test_kalman - test the sequential update of the extended Kalman filter.
+
+=head1 SYNOPSIS
+
+    libbi test_kalman --model-file Model.bi ...
+
+=head1 DESCRIPTION
+
+Draws random predictions, observation Jacobians, observation noise factors
+and observations, then updates the prediction both with the sequential
+update of the extended Kalman filter, one observation at a time, and with
+its batch update, and checks that the two give the same log-likelihood,
+mean and covariance. A model is required to construct the filter, but plays
+no part in the test. Exits with an error on the first failed check.
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=cut
+
+package Bi::Test::test_kalman;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--ndims> (default 8)
+
+Size of the state.
+
+=item C<--nobs> (default 3)
+
+Number of observations, no greater than C<--ndims>.
+
+=item C<--reps> (default 100)
+
+Number of random updates to check.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'ndims',
+      type => 'int',
+      default => 8
+    },
+    {
+      name => 'nobs',
+      type => 'int',
+      default => 3
+    },
+    {
+      name => 'reps',
+      type => 'int',
+      default => 100
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    $self->{_binary} = 'test_kalman';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+1;
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
@@ -102,13 +102,23 @@ sub evaluate {
         $actionSetParam0->set_right($right);
         $actionSetParam0->validate;
         $parameter_block->unshift_child($actionSetParam0->clone);
+        # define a state variable to offset the mean of each particle from
+        # $param0; it is zero unless set by a sampler, e.g. to the swarm of
+        # the last iteration of IF2
+        my $paramc = new Bi::Model::Var('state', $param->get_name . "_c_",
+            [], [], {
+            'has_input' => new Bi::Expression::IntegerLiteral(0),
+            'has_output' => new Bi::Expression::IntegerLiteral(0)
+        });
+        $model->push_var($paramc);
         # create an action to put in the initial block:
-        # $param ~ gaussian(mean = $param_0_, sd = $tau)
+        # $param ~ gaussian(mean = $param_0_ + $param_c_, sd = $tau)
         my $actionGaussian = new Bi::Action;
         $left = new Bi::Expression::VarIdentifier($param);
         my $name = 'gaussian';
         my $named_args = {
-            'mean' =>new Bi::Expression::VarIdentifier($param0),
+            'mean' => new Bi::Expression::VarIdentifier($param0) +
+                new Bi::Expression::VarIdentifier($paramc),
             'std' => new Bi::Expression::VarIdentifier($tau)
         };
         $actionGaussian->set_left($left);
@@ -11,6 +11,8 @@
 #include "../math/vector.hpp"
 #include "../math/matrix.hpp"
 
+#include "boost/serialization/split_member.hpp"
+
 namespace bi {
 /**
  * Adapter for Gaussian proposal.
@@ -95,6 +97,24 @@ private:
    * Minimum relative ESS to be considered ready.
    */
   double essRel;
+
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
 };
 }
 
@@ -108,6 +128,7 @@ private:
 #include "../pdf/misc.hpp"
 #include "../primitive/vector_primitive.hpp"
 #include "../cuda/cuda.hpp"
+#include "../math/serialization.hpp"
 #include "../mpi/mpi.hpp"
 
 template<class S1>
@@ -252,4 +273,20 @@ void bi::GaussianAdapter::propose(Random& rng, S1& s1, S2& s2) {
   synchronize();
 }
 
+template<class Archive>
+void bi::GaussianAdapter::save(Archive& ar, const unsigned version) const {
+  save_resizable_vector(ar, version, mu);
+  save_resizable_matrix(ar, version, Sigma);
+  save_resizable_matrix(ar, version, U);
+  ar & detU;
+}
+
+template<class Archive>
+void bi::GaussianAdapter::load(Archive& ar, const unsigned version) {
+  load_resizable_vector(ar, version, mu);
+  load_resizable_matrix(ar, version, Sigma);
+  load_resizable_matrix(ar, version, U);
+  ar & detU;
+}
+
 #endif
@@ -27,6 +27,13 @@ public:
     return 0.0;
   }
 
+  /**
+   * Get number of times.
+   */
+  size_t numTimes() const {
+    return 0;
+  }
+
   /**
    * Read times.
    *
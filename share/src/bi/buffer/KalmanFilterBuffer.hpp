@@ -78,6 +78,7 @@ void bi::KalmanFilterBuffer<IO1>::write(const size_t k, const real t,
   parent_type::writeCorrectedMean(k, s.mu2);
   parent_type::writeCorrectedStd(k, s.U2);
   parent_type::writeCross(k, s.C);
+  parent_type::writeTimer(k, s.timer);
 }
 
 template<class IO1>
@@ -71,6 +71,7 @@ void bi::ParticleFilterBuffer<IO1>::write(const size_t k, const real t,
   parent_type::writeTime(k, t);
   parent_type::writeState(k, s.getDyn(), s.ancestors());
   parent_type::writeLogWeights(k, s.logWeights());
+  parent_type::writeTimer(k, s.timer);
 }
 
 template<class IO1>
@@ -80,6 +80,7 @@ void bi::SimulatorBuffer<IO1>::write(const size_t k, const real t,
     const S1& s) {
   IO1::writeTime(k, t);
   IO1::writeState(k, s.getDyn());
+  IO1::writeTimer(k, s.timer);
 }
 
 template<class IO1>
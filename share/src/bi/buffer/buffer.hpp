@@ -56,7 +56,13 @@ enum FileMode {
    * Open file for reading and writing, fails if any existing file of the
    * same name
    */
-  NEW
+  NEW,
+
+  /**
+   * Open existing file for reading and writing, to add records after those
+   * already written along its unlimited dimension.
+   */
+  APPEND
 };
 }
 
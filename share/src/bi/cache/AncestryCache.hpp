@@ -23,6 +23,18 @@ namespace bi {
  * @ingroup io_cache
  *
  * @tparam CL Cache location.
+ *
+ * By default the full ancestry is kept, back to the first generation. For
+ * fixed-lag smoothing, a lag \f$L\f$ may be set with setLag(), in which case
+ * only the last \f$L+1\f$ generations are kept: after each new generation is
+ * added, its ancestors \f$L\f$ generations back become roots of the tree,
+ * and all older nodes are removed. Memory for the tree is then bounded in
+ * the number of particles and the lag, rather than growing with the number
+ * of generations, and paths are read in time linear in the lag. Before
+ * each truncation, the fixed-lag estimate of the state at the new root
+ * generation is kept, so that paths remain complete: this is the state, at
+ * that generation, on the lineage of the first particle of the youngest
+ * generation, and is unique once lineages have coalesced within the lag.
  */
 template<Location CL = ON_HOST>
 class AncestryCache {
@@ -37,6 +49,11 @@ public:
    */
   typedef typename loc_vector<CL,int>::type int_vector_type;
 
+  /**
+   * Integer matrix type.
+   */
+  typedef typename loc_matrix<CL,int>::type int_matrix_type;
+
   /**
    * Constructor.
    */
@@ -67,6 +84,24 @@ public:
    */
   void empty();
 
+  /**
+   * Get the lag.
+   *
+   * @return Number of generations, before the youngest, for which ancestry
+   * is kept, zero if the full ancestry is kept.
+   */
+  int getLag() const;
+
+  /**
+   * Set the lag.
+   *
+   * @param lag Number of generations, before the youngest, for which
+   * ancestry is kept, zero to keep the full ancestry.
+   *
+   * Should be called before the first generation is added to the cache.
+   */
+  void setLag(const int lag);
+
   /**
    * Read single path from the cache.
    *
@@ -74,6 +109,10 @@ public:
    *
    * @param p Index of particle at current time.
    * @param[out] X Path. Rows index variables, columns index times.
+   *
+   * If a lag is set, states older than the lag are no longer held in the
+   * tree, and the corresponding columns of @p X are set to their fixed-lag
+   * estimates instead.
    */
   template<class M1>
   void readPath(const int p, M1 X) const;
@@ -97,6 +136,11 @@ public:
    * @name Diagnostics
    */
   //@{
+  /**
+   * Number of nodes in the ancestry tree.
+   */
+  int numNodes() const;
+
   /**
    * Report to stderr.
    */
@@ -119,6 +163,11 @@ private:
    */
   void prune();
 
+  /**
+   * Truncate the ancestry tree at the oldest generation within the lag.
+   */
+  void truncate();
+
   /**
    * Insert a new generation of particles into the tree.
    *
@@ -178,6 +227,41 @@ private:
    */
   int_vector_type ls;
 
+  /**
+   * Generations. Each entry, corresponding to a row in @p Xs, gives the
+   * generation of the particle held in that row.
+   */
+  int_vector_type gs;
+
+  /**
+   * Leaves of each generation within the lag. Column @c g%(lag+1) holds the
+   * leaves of generation @c g, in its leading rows. Only kept if a lag is
+   * set.
+   */
+  int_matrix_type Ls;
+
+  /**
+   * Number of leaves in each column of @p Ls.
+   */
+  host_vector<int> ns;
+
+  /**
+   * Fixed-lag estimates. Row @c h holds the estimate of the state at
+   * generation @c h, for each generation no longer held in the tree. Only
+   * kept if a lag is set.
+   */
+  host_matrix<real> Es;
+
+  /**
+   * Generation of youngest particles.
+   */
+  int g;
+
+  /**
+   * Lag, zero if none.
+   */
+  int lag;
+
   /**
    * Number of surviving nodes in the cache.
    */
@@ -227,16 +311,18 @@ private:
 #include "../primitive/matrix_primitive.hpp"
 
 #include <iomanip>
+#include <limits>
 
 template<bi::Location CL>
 bi::AncestryCache<CL>::AncestryCache() :
-    m(0), q(0), usecs(0) {
+    g(0), lag(0), m(0), q(0), usecs(0) {
   //
 }
 
 template<bi::Location CL>
 bi::AncestryCache<CL>::AncestryCache(const AncestryCache<CL>& o) :
-    Xs(o.Xs), as(o.as), os(o.os), ls(o.ls), m(o.m), q(o.q), usecs(o.usecs) {
+    Xs(o.Xs), as(o.as), os(o.os), ls(o.ls), gs(o.gs), Ls(o.Ls), ns(o.ns), Es(
+        o.Es), g(o.g), lag(o.lag), m(o.m), q(o.q), usecs(o.usecs) {
   //
 }
 
@@ -247,11 +333,21 @@ bi::AncestryCache<CL>& bi::AncestryCache<CL>::operator=(
   as.resize(o.as.size(), false);
   os.resize(o.os.size(), false);
   ls.resize(o.ls.size(), false);
+  gs.resize(o.gs.size(), false);
+  Ls.resize(o.Ls.size1(), o.Ls.size2(), false);
+  ns.resize(o.ns.size(), false);
+  Es.resize(o.Es.size1(), o.Es.size2(), false);
 
   Xs = o.Xs;
   as = o.as;
   os = o.os;
   ls = o.ls;
+  gs = o.gs;
+  Ls = o.Ls;
+  ns = o.ns;
+  Es = o.Es;
+  g = o.g;
+  lag = o.lag;
   m = o.m;
   q = o.q;
   usecs = o.usecs;
@@ -265,6 +361,12 @@ void bi::AncestryCache<CL>::swap(AncestryCache<CL>& o) {
   as.swap(o.as);
   os.swap(o.os);
   ls.swap(o.ls);
+  gs.swap(o.gs);
+  Ls.swap(o.Ls);
+  ns.swap(o.ns);
+  Es.swap(o.Es);
+  std::swap(g, o.g);
+  std::swap(lag, o.lag);
   std::swap(m, o.m);
   std::swap(q, o.q);
   std::swap(usecs, o.usecs);
@@ -274,6 +376,7 @@ template<bi::Location CL>
 void bi::AncestryCache<CL>::clear() {
   os.clear();
   ls.resize(0, false);
+  g = 0;
   m = 0;
   q = 0;
   usecs = 0;
@@ -285,11 +388,29 @@ void bi::AncestryCache<CL>::empty() {
   as.resize(0, false);
   os.resize(0, false);
   ls.resize(0, false);
+  gs.resize(0, false);
+  Ls.resize(0, 0, false);
+  ns.resize(0, false);
+  Es.resize(0, 0, false);
+  g = 0;
   m = 0;
   q = 0;
   usecs = 0;
 }
 
+template<bi::Location CL>
+inline int bi::AncestryCache<CL>::getLag() const {
+  return lag;
+}
+
+template<bi::Location CL>
+inline void bi::AncestryCache<CL>::setLag(const int lag) {
+  /* pre-condition */
+  BI_ASSERT(lag >= 0);
+
+  this->lag = lag;
+}
+
 template<bi::Location CL>
 template<class M1>
 void bi::AncestryCache<CL>::readPath(const int p, M1 X) const {
@@ -308,7 +429,18 @@ void bi::AncestryCache<CL>::readPath(const int p, M1 X) const {
     column(X, t) = row(Xs, a);
     a = as1(a);
     --t;
-  } while (a != -1);
+  } while (a != -1 && t >= 0);
+
+  /* fixed-lag estimates for generations no longer in the tree, where
+   * column t holds generation h */
+  int h = g - (X.size2() - 1 - t);
+  for (; t >= 0 && h >= 0 && h < g - lag && h < Es.size1(); --t, --h) {
+    column(X, t) = row(Es, h);
+  }
+  if (t >= 0) {
+    matrix_set_elements(columns(X, 0, t + 1),
+        std::numeric_limits<real>::quiet_NaN());
+  }
 }
 
 template<bi::Location CL>
@@ -333,7 +465,9 @@ void bi::AncestryCache<CL>::init(const M1 X) {
 
   set_elements(subrange(as, 0, N), -1);
   set_elements(subrange(os, 0, N), 0);
+  set_elements(subrange(gs, 0, N), 0);
   seq_elements(subrange(ls, 0, N), 0);
+  g = 0;
   m = N;
   q = 0;
 }
@@ -350,6 +484,48 @@ void bi::AncestryCache<CL>::prune() {
   m -= impl::prune(this->as, this->os, this->ls);
 }
 
+template<bi::Location CL>
+void bi::AncestryCache<CL>::truncate() {
+#ifdef __CUDACC__
+  typedef typename boost::mpl::if_c<CL == ON_DEVICE,
+  AncestryCacheGPU,
+  AncestryCacheHost>::type impl;
+#else
+  typedef AncestryCacheHost impl;
+#endif
+  const int N = ls.size();
+
+  /* record leaves of youngest generation */
+  if (Ls.size1() < N || Ls.size2() != lag + 1) {
+    Ls.resize(bi::max(Ls.size1(), N), lag + 1, true);
+    ns.resize(lag + 1, true);
+  }
+  int c = g % (lag + 1);
+  subrange(column(Ls, c), 0, N) = ls;
+  ns(c) = N;
+
+  /* fixed-lag estimate at oldest generation within lag, from the lineage
+   * of the first leaf */
+  if (g >= lag) {
+    int a = *ls.begin();
+    for (int i = 0; i < lag; ++i) {
+      a = *(as.begin() + a);
+    }
+    const int h = g - lag;
+    if (Es.size1() <= h || Es.size2() != Xs.size2()) {
+      Es.resize(bi::max(2 * Es.size1(), h + 1), Xs.size2(), true);
+    }
+    row(Es, h) = row(Xs, a);
+  }
+
+  /* truncate at oldest generation within lag */
+  if (g > lag) {
+    c = (g - lag) % (lag + 1);
+    m -= impl::truncate(this->as, this->os, this->gs,
+        subrange(column(Ls, c), 0, ns(c)), g - lag);
+  }
+}
+
 template<bi::Location CL>
 template<class M1, class V1>
 void bi::AncestryCache<CL>::insert(const M1 X, const V1 as) {
@@ -362,6 +538,12 @@ void bi::AncestryCache<CL>::insert(const M1 X, const V1 as) {
 #endif
   q = impl::insert(this->Xs, this->as, this->os, this->ls, q, X, as);
   m += X.size1();
+
+  /* record generation */
+  ++g;
+  int_vector_type gs1(ls.size());
+  set_elements(gs1, g);
+  bi::scatter(ls, gs1, gs);
 }
 
 template<bi::Location CL>
@@ -391,6 +573,7 @@ void bi::AncestryCache<CL>::enlarge(const int N) {
   Xs.resize(newSize, Xs.size2(), true);
   as.resize(newSize, true);
   os.resize(newSize, true);
+  gs.resize(newSize, true);
   subrange(os, oldSize, newSize - oldSize).clear();
   q = oldSize;
 
@@ -398,6 +581,7 @@ void bi::AncestryCache<CL>::enlarge(const int N) {
   BI_ASSERT(Xs.size1() - m >= N);
   BI_ASSERT(Xs.size1() == as.size());
   BI_ASSERT(Xs.size1() == os.size());
+  BI_ASSERT(Xs.size1() == gs.size());
 }
 
 template<bi::Location CL>
@@ -414,6 +598,9 @@ void bi::AncestryCache<CL>::writeState(const M1 X, const V1 as,
 
   if (m == 0) {
     init(X);
+    if (lag > 0) {
+      truncate();
+    }
   } else {
     int_vector_type os(ls.size());
     ancestorsToOffspring(as, os);
@@ -426,6 +613,9 @@ void bi::AncestryCache<CL>::writeState(const M1 X, const V1 as,
       enlarge(X.size1());
     }
     insert(X, as);
+    if (lag > 0) {
+      truncate();
+    }
   }
 #if ENABLE_DIAGNOSTICS == 1
   synchronize();
@@ -434,6 +624,11 @@ void bi::AncestryCache<CL>::writeState(const M1 X, const V1 as,
 #endif
 }
 
+template<bi::Location CL>
+inline int bi::AncestryCache<CL>::numNodes() const {
+  return m;
+}
+
 template<bi::Location CL>
 void bi::AncestryCache<CL>::report() const {
   std::cerr << "AncestryCache: ";
@@ -450,6 +645,12 @@ void bi::AncestryCache<CL>::save(Archive& ar, const unsigned version) const {
   save_resizable_vector(ar, version, as);
   save_resizable_vector(ar, version, os);
   save_resizable_vector(ar, version, ls);
+  save_resizable_vector(ar, version, gs);
+  save_resizable_matrix(ar, version, Ls);
+  save_resizable_vector(ar, version, ns);
+  save_resizable_matrix(ar, version, Es);
+  ar & g;
+  ar & lag;
   ar & m;
   ar & q;
   ar & usecs;
@@ -462,6 +663,12 @@ void bi::AncestryCache<CL>::load(Archive& ar, const unsigned version) {
   load_resizable_vector(ar, version, as);
   load_resizable_vector(ar, version, os);
   load_resizable_vector(ar, version, ls);
+  load_resizable_vector(ar, version, gs);
+  load_resizable_matrix(ar, version, Ls);
+  load_resizable_vector(ar, version, ns);
+  load_resizable_matrix(ar, version, Es);
+  ar & g;
+  ar & lag;
   ar & m;
   ar & q;
   ar & usecs;
@@ -83,6 +83,16 @@ public:
   template<class M1>
   void readPath(const int p, M1 X) const;
 
+  /**
+   * @copydoc AncestryCache::getLag()
+   */
+  int getLag() const;
+
+  /**
+   * @copydoc AncestryCache::setLag()
+   */
+  void setLag(const int lag);
+
   /**
    * Swap the contents of the cache with that of another.
    */
@@ -212,6 +222,16 @@ void bi::BootstrapPFCache<CL,IO1>::readPath(const int p, M1 X) const {
   ancestryCache.readPath(p, X);
 }
 
+template<bi::Location CL, class IO1>
+inline int bi::BootstrapPFCache<CL,IO1>::getLag() const {
+  return ancestryCache.getLag();
+}
+
+template<bi::Location CL, class IO1>
+inline void bi::BootstrapPFCache<CL,IO1>::setLag(const int lag) {
+  ancestryCache.setLag(lag);
+}
+
 template<bi::Location CL, class IO1>
 void bi::BootstrapPFCache<CL,IO1>::swap(BootstrapPFCache<CL,IO1>& o) {
   parent_type::swap(o);
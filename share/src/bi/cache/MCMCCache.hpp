@@ -49,7 +49,8 @@ public:
   MCMCCache<CL,IO1>& operator=(const MCMCCache<CL,IO1>& o);
 
   /**
-   * Read log-likelihood.
+   * Read log-likelihood. If the sample is not in the cache, it is read from
+   * the output buffer.
    *
    * @param p Sample index.
    *
@@ -66,7 +67,8 @@ public:
   void writeLogLikelihood(const int p, const real ll);
 
   /**
-   * Read log-prior density.
+   * Read log-prior density. If the sample is not in the cache, it is read
+   * from the output buffer.
    *
    * @param p Sample index.
    *
@@ -131,6 +133,11 @@ public:
    */
   bool isFull() const;
 
+  /**
+   * Is cache empty?
+   */
+  bool isEmpty() const;
+
   /**
    * Swap the contents of the cache with that of another.
    */
@@ -273,10 +280,11 @@ bi::MCMCCache<CL,IO1>& bi::MCMCCache<CL,IO1>::operator=(
 
 template<bi::Location CL, class IO1>
 real bi::MCMCCache<CL,IO1>::readLogLikelihood(const int p) {
-  /* pre-condition */
-  BI_ASSERT(p >= first && p < first + len);
-
-  return llCache.get(p - first);
+  if (p >= first && p < first + len) {
+    return llCache.get(p - first);
+  } else {
+    return parent_type::readLogLikelihood(p);
+  }
 }
 
 template<bi::Location CL, class IO1>
@@ -295,10 +303,11 @@ void bi::MCMCCache<CL,IO1>::writeLogLikelihood(const int p, const real ll) {
 
 template<bi::Location CL, class IO1>
 real bi::MCMCCache<CL,IO1>::readLogPrior(const int p) {
-  /* pre-condition */
-  BI_ASSERT(p >= first && p < first + len);
-
-  return lpCache.get(p - first);
+  if (p >= first && p < first + len) {
+    return lpCache.get(p - first);
+  } else {
+    return parent_type::readLogPrior(p);
+  }
 }
 
 template<bi::Location CL, class IO1>
@@ -373,6 +382,11 @@ bool bi::MCMCCache<CL,IO1>::isFull() const {
   return len == NUM_SAMPLES;
 }
 
+template<bi::Location CL, class IO1>
+bool bi::MCMCCache<CL,IO1>::isEmpty() const {
+  return len == 0;
+}
+
 template<bi::Location CL, class IO1>
 void bi::MCMCCache<CL,IO1>::swap(MCMCCache<CL,IO1>& o) {
   parent_type::swap(o);
@@ -8,6 +8,11 @@
 
 #include "Cache1D.hpp"
 #include "../null/SimulatorNullBuffer.hpp"
+#include "../misc/PhaseTimer.hpp"
+
+#include "boost/serialization/vector.hpp"
+
+#include <vector>
 
 namespace bi {
 /**
@@ -65,6 +70,11 @@ public:
   template<class V1>
   void writeTimes(const int k, const V1 ts);
 
+  /**
+   * @copydoc SimulatorNetCDFBuffer::writeTimer()
+   */
+  void writeTimer(const int k, const PhaseTimer& timer);
+
   /**
    * Swap the contents of the cache with that of another.
    */
@@ -87,6 +97,9 @@ public:
 
   /**
    * Flush cache to output buffer.
+   *
+   * Only times and timers from the first index written since the last
+   * flush are written to the buffer.
    */
   void flush();
 
@@ -103,6 +116,16 @@ public:
   int len;
 
 private:
+  /**
+   * Execution time by phase cache.
+   */
+  std::vector<PhaseTimer> timerCache;
+
+  /**
+   * Number of leading times and timers unchanged since the last flush.
+   */
+  int flushed;
+
   /**
    * Serialize.
    */
@@ -127,13 +150,14 @@ template<bi::Location CL, class IO1>
 bi::SimulatorCache<CL,IO1>::SimulatorCache(const Model& m, const size_t P,
     const size_t T, const std::string& file, const FileMode mode,
     const SchemaMode schema) :
-    IO1(m, P, T, file, mode, schema), len(0) {
+    IO1(m, P, T, file, mode, schema), len(0), flushed(0) {
   //
 }
 
 template<bi::Location CL, class IO1>
 bi::SimulatorCache<CL,IO1>::SimulatorCache(const SimulatorCache<CL,IO1>& o) :
-    IO1(o), timeCache(o.timeCache), len(o.len) {
+    IO1(o), timeCache(o.timeCache), len(o.len), timerCache(o.timerCache),
+    flushed(o.flushed) {
   //
 }
 
@@ -147,6 +171,8 @@ bi::SimulatorCache<CL,IO1>& bi::SimulatorCache<CL,IO1>::operator=(
     const SimulatorCache<CL,IO1>& o) {
   timeCache = o.timeCache;
   len = o.len;
+  timerCache = o.timerCache;
+  flushed = o.flushed;
 
   return *this;
 }
@@ -168,6 +194,9 @@ inline void bi::SimulatorCache<CL,IO1>::writeTime(const int k,
   if (k == len) {
     ++len;
   }
+  if (k < flushed) {
+    flushed = k;
+  }
   timeCache.set(k, t);
 }
 
@@ -189,13 +218,33 @@ inline void bi::SimulatorCache<CL,IO1>::writeTimes(const int k, const V1 ts) {
   if (k + ts.size() > len) {
     len = k + ts.size();
   }
+  if (k < flushed) {
+    flushed = k;
+  }
   timeCache.set(k, ts.size(), ts);
 }
 
+template<bi::Location CL, class IO1>
+inline void bi::SimulatorCache<CL,IO1>::writeTimer(const int k,
+    const PhaseTimer& timer) {
+  /* pre-condition */
+  BI_ASSERT(k >= 0);
+
+  if (k >= int(timerCache.size())) {
+    timerCache.resize(k + 1);
+  }
+  if (k < flushed) {
+    flushed = k;
+  }
+  timerCache[k] = timer;
+}
+
 template<bi::Location CL, class IO1>
 inline void bi::SimulatorCache<CL,IO1>::swap(SimulatorCache<CL,IO1>& o) {
   timeCache.swap(o.timeCache);
   std::swap(len, o.len);
+  timerCache.swap(o.timerCache);
+  std::swap(flushed, o.flushed);
 }
 
 template<bi::Location CL, class IO1>
@@ -207,18 +256,28 @@ template<bi::Location CL, class IO1>
 inline void bi::SimulatorCache<CL,IO1>::clear() {
   timeCache.clear();
   len = 0;
+  timerCache.clear();
+  flushed = 0;
 }
 
 template<bi::Location CL, class IO1>
 inline void bi::SimulatorCache<CL,IO1>::empty() {
   timeCache.empty();
   len = 0;
+  timerCache.clear();
+  flushed = 0;
 }
 
 template<bi::Location CL, class IO1>
 inline void bi::SimulatorCache<CL,IO1>::flush() {
-  IO1::writeTimes(0, timeCache.get(0, len));
+  if (len > flushed) {
+    IO1::writeTimes(flushed, timeCache.get(flushed, len - flushed));
+  }
   timeCache.flush();
+  for (int k = flushed; k < int(timerCache.size()); ++k) {
+    IO1::writeTimer(k, timerCache[k]);
+  }
+  flushed = bi::max(len, int(timerCache.size()));
 }
 
 template<bi::Location CL, class IO1>
@@ -227,6 +286,8 @@ void bi::SimulatorCache<CL,IO1>::save(Archive& ar,
     const unsigned version) const {
   ar & timeCache;
   ar & len;
+  ar & timerCache;
+  ar & flushed;
 }
 
 template<bi::Location CL, class IO1>
@@ -234,6 +295,8 @@ template<class Archive>
 void bi::SimulatorCache<CL,IO1>::load(Archive& ar, const unsigned version) {
   ar & timeCache;
   ar & len;
+  ar & timerCache;
+  ar & flushed;
 }
 
 #endif
@@ -23,6 +23,12 @@ public:
   template<class V1>
   static int prune(V1& as, V1& os, V1& ls);
 
+  /**
+   * @copydoc AncestryCacheHost::truncate()
+   */
+  template<class V1, class V2>
+  static int truncate(V1& as, V1& os, V1& gs, const V2 rs, const int g);
+
   /**
    * Insert into ancestry tree.
    *
@@ -71,6 +77,23 @@ int bi::AncestryCacheGPU::prune(V1& as, V1& os, V1& ls) {
   return sum_reduce(numRemoved);
 }
 
+template<class V1, class V2>
+int bi::AncestryCacheGPU::truncate(V1& as, V1& os, V1& gs, const V2 rs,
+    const int g) {
+  /* pre-condition */
+  BI_ASSERT(V1::on_device);
+
+  ///@todo Implement as kernel, rather than round trip to host
+  typename temp_host_vector<int>::type as1(as), os1(os), gs1(gs), rs1(rs);
+  synchronize();
+
+  int numRemoved = AncestryCacheHost::truncate(as1, os1, gs1, rs1, g);
+  as = as1;
+  os = os1;
+
+  return numRemoved;
+}
+
 template<class M1, class V1, class M2, class V2>
 int bi::AncestryCacheGPU::insert(M1& X, V1& as, V1& os, V1& ls, const int start, const M2 X1,
     const V2 as1) {
@@ -208,6 +208,15 @@ struct potrs_impl<ON_DEVICE,T1> {
   static void func(const M1 U, M2 X, char uplo);
 };
 
+/**
+ * @internal
+ */
+template<class T1>
+struct geqrf_impl<ON_DEVICE,T1> {
+  template<class M1, class V1, class V2>
+  static void func(M1 A, V1 tau, V2 work);
+};
+
 /**
  * @internal
  */
@@ -451,6 +460,12 @@ void bi::potrs_impl<bi::ON_DEVICE,T1>::func(const M1 U, M2 X, char uplo) {
   BI_ERROR_MSG(false, "Not implemented");
 }
 
+template<class T1>
+template<class M1, class V1, class V2>
+void bi::geqrf_impl<bi::ON_DEVICE,T1>::func(M1 A, V1 tau, V2 work) {
+  BI_ERROR_MSG(false, "Not implemented");
+}
+
 template<class T1>
 template<class M1, class V1, class M2, class V2, class V3, class V4, class V5>
 void bi::syevx_impl<bi::ON_DEVICE,T1>::func(char jobz, char range, char uplo,
@@ -7,6 +7,15 @@
 #define BI_CUDA_PRIMITIVE_MATRIXPRIMITIVE_CUH
 
 namespace bi {
+/**
+ * @internal
+ */
+template<>
+struct clear_rows_impl<ON_DEVICE> {
+  template<class M1>
+  static void func(M1 X);
+};
+
 /**
  * @internal
  */
@@ -64,6 +73,11 @@ struct scatter_matrix_impl<ON_DEVICE> {
 
 #include "matrix_primitive_kernel.cuh"
 
+template<class M1>
+void bi::clear_rows_impl<bi::ON_DEVICE>::func(M1 X) {
+  X.clear();
+}
+
 template<class V1, class M1, class M2>
 void bi::gather_rows_impl<bi::ON_DEVICE>::func(const V1 map, const M1 X,
     M2 Y) {
@@ -22,6 +22,18 @@ namespace bi {
  * @tparam O Observer type.
  * @tparam R Resampler type.
  * @tparam S2 Stopper type.
+ *
+ * At each step, particles are propagated first in one large block, of the
+ * size that the stopping criterion required at the previous step, then in
+ * smaller correction blocks of fixed size until the criterion is met.
+ * Weights are added to the stopper a correction block's worth at a time,
+ * and the particles of the sub-block in which it fires are discarded, to
+ * avoid stopping-time bias. If the step ends for any other reason, all
+ * particles are kept. Optionally, the real time
+ * of each step is limited by a budget: no further correction blocks are
+ * started once it has been exceeded, and the size of the large block is
+ * limited to that expected to fit within it, given the time per particle
+ * at the previous step.
  */
 template<class B, class F, class O, class R, class S2>
 class AdaptivePF: public BootstrapPF<B,F,O,R> {
@@ -35,10 +47,12 @@ public:
    * @param resam Resampler.
    * @param stopper Stopping criterion for adapting number of particles.
    * @param initialP Number of particles at first time.
-   * @param blockP Number of particles per block.
+   * @param blockP Number of particles per correction block.
+   * @param budget Real time allocated to each step, in seconds. Zero for no
+   * limit.
    */
   AdaptivePF(B& m, F& in, O& obs, R& resam, S2& stopper, const int initialP,
-      const int blockP);
+      const int blockP, const double budget = 0.0);
 
   /**
    * @copydoc BootstrapPF::init()
@@ -53,6 +67,12 @@ public:
   template<class S1, class IO1>
   void init(Random& rng, const ScheduleElement now, S1& s, IO1& out);
 
+  /**
+   * @copydoc Simulator::init(const V1, const ScheduleElement, S1&, IO1&)
+   */
+  template<class V1, class S1, class IO1>
+  void init(const V1 theta, const ScheduleElement now, S1& s, IO1& out);
+
   /**
    * @name High-level interface
    *
@@ -82,6 +102,11 @@ public:
   //@}
 
 private:
+  /**
+   * Size of the first block of a step.
+   */
+  int firstBlockSize() const;
+
   /**
    * Stopping criterion.
    */
@@ -96,17 +121,34 @@ private:
    * Block size.
    */
   int blockP;
+
+  /**
+   * Real time allocated to each step, in microseconds.
+   */
+  long budget;
+
+  /**
+   * Number of particles required at the previous step.
+   */
+  int predictP;
+
+  /**
+   * Real time per particle at the previous step, in microseconds.
+   */
+  double rate;
 };
 }
 
 #include "../primitive/vector_primitive.hpp"
 #include "../primitive/matrix_primitive.hpp"
+#include "../misc/TicToc.hpp"
 
 template<class B, class F, class O, class R, class S2>
 bi::AdaptivePF<B,F,O,R,S2>::AdaptivePF(B& m, F& in, O& obs, R& resam,
-    S2& stopper, const int initialP, const int blockP) :
+    S2& stopper, const int initialP, const int blockP, const double budget) :
     BootstrapPF<B,F,O,R>(m, in, obs, resam), stopper(stopper), initialP(
-        initialP), blockP(blockP) {
+        initialP), blockP(blockP), budget(1e6 * budget), predictP(initialP),
+        rate(0.0) {
   //
 }
 
@@ -118,6 +160,8 @@ void bi::AdaptivePF<B,F,O,R,S2>::init(Random& rng, const ScheduleElement now,
     s.resizeMax(initialP);
   }
   s.setRange(0, initialP);
+  predictP = initialP;
+  rate = 0.0;
   BootstrapPF<B,F,O,R>::init(rng, now, s, out, inInit);
 }
 
@@ -129,9 +173,24 @@ void bi::AdaptivePF<B,F,O,R,S2>::init(Random& rng, const ScheduleElement now,
     s.resizeMax(initialP);
   }
   s.setRange(0, initialP);
+  predictP = initialP;
+  rate = 0.0;
   BootstrapPF<B,F,O,R>::init(rng, now, s, out);
 }
 
+template<class B, class F, class O, class R, class S2>
+template<class V1, class S1, class IO1>
+void bi::AdaptivePF<B,F,O,R,S2>::init(const V1 theta,
+    const ScheduleElement now, S1& s, IO1& out) {
+  if (s.size() < initialP) {
+    s.resizeMax(initialP);
+  }
+  s.setRange(0, initialP);
+  predictP = initialP;
+  rate = 0.0;
+  BootstrapPF<B,F,O,R>::init(theta, now, s, out);
+}
+
 template<class B, class F, class O, class R, class S2>
 template<class S1, class IO1>
 void bi::AdaptivePF<B,F,O,R,S2>::step(Random& rng, ScheduleIterator& iter,
@@ -157,8 +216,10 @@ void bi::AdaptivePF<B,F,O,R,S2>::step(Random& rng, ScheduleIterator& iter,
   BOOST_AUTO(iter1, iter);
 
   /* marginal log-likelihood increment */
+  s.timer.tic();
   s.logLikelihood += logsumexp_reduce(s.logWeights())
       - bi::log(static_cast<double>(s.size()));
+  s.timer.toc(PHASE_REDUCE);
 
   /* prepare resampler */
   if (iter->isObserved() && resampler_needs_max<R>::value) {
@@ -166,32 +227,38 @@ void bi::AdaptivePF<B,F,O,R,S2>::step(Random& rng, ScheduleIterator& iter,
   }
   typename precompute_type<R,S1::location>::type pre;
   this->resam.precompute(s.logWeights(), pre);
+  s.timer.toc(PHASE_RESAMPLE);
 
-  /* propagate block by block */
+  /* propagate one large block, then correction blocks as required */
+  TicToc clock;
+  int start = 0, size = firstBlockSize(), need = 0, length = -1, j, n;
+  bool stop = false;
   this->stopper.reset();
   do {
-    if (s.sizeMax() < (block + 1) * blockP) {
-      s.resizeMax((block + 1) * blockP);
+    if (s.sizeMax() < start + size) {
+      s.resizeMax(start + size);
     }
-    s.setRange(block * blockP, blockP);
+    s.setRange(start, size);
     iter1 = iter;
 
     do {
       /* resample */
+      s.timer.tic();
       if (iter1->isObserved() || iter1->indexTime() == 0) {
         if (iter1->hasOutput()) {
           this->resam.ancestors(rng, lws, s.ancestors(), pre);
           this->resam.copy(s.ancestors(), X, s.getDyn());
         } else {
-          typename S1::temp_int_vector_type as1(blockP);
+          typename S1::temp_int_vector_type as1(size);
           this->resam.ancestors(rng, lws, as1, pre);
           this->resam.copy(as1, X, s.getDyn());
           bi::gather(as1, as, s.ancestors());
         }
         s.logWeights().clear();
       } else if (iter1->hasOutput()) {
-        seq_elements(s.ancestors(), block * blockP);
+        seq_elements(s.ancestors(), start);
       }
+      s.timer.toc(PHASE_RESAMPLE);
 
       ++iter1;
       this->predict(rng, *iter1, s);
@@ -203,18 +270,52 @@ void bi::AdaptivePF<B,F,O,R,S2>::step(Random& rng, ScheduleIterator& iter,
       if (block == 0) {
         maxlw = this->getMaxLogWeight(*iter1, s);
       }
-      stopper.add(s.logWeights(), maxlw);
+
+      /* add weights a block at a time, so as to count the number of
+       * particles actually required, even within the first block */
+      for (j = 0; j < size && !stop; j += n) {
+        n = bi::min(blockP, size - j);
+        stopper.add(subrange(s.logWeights(), j, n), maxlw);
+        need += n;
+        stop = stopper.stop(maxlw);
+      }
+      if (stop) {
+        /* the sub-block in which the stopper fired is dropped, unless it is
+         * the only one, to avoid stopping-time bias */
+        length = bi::max(start + j - n, n);
+      }
     }
+    start += size;
+    size = blockP;
     ++block;
-  } while (iter1->isObserved() && !stopper.stop(maxlw));  // may not be observed at last time
+  } while (iter1->isObserved() && !stop
+      && (budget <= 0 || clock.toc() < budget));  // may not be observed at last time
+
+  /* predict for next step */
+  if (iter1->isObserved()) {
+    predictP = bi::max(need, 1);
+  }
+  rate = static_cast<double>(clock.toc()) / start;
 
-  int length = bi::max(block - 1, 1) * blockP;  // drop last block
+  if (!stop) {
+    /* ended by budget or at an unobserved time, keep all particles */
+    length = start;
+  }
   out.push(length);
   s.setRange(0, length);
   //s.trim(); // optional, saves memory but means reallocation
   iter = iter1;  // caller expects iter to be advanced at end of step()
 }
 
+template<class B, class F, class O, class R, class S2>
+int bi::AdaptivePF<B,F,O,R,S2>::firstBlockSize() const {
+  int P = predictP;
+  if (budget > 0 && rate > 0.0) {
+    P = bi::min(P, static_cast<int>(budget / rate));
+  }
+  return bi::max(blockP, ((P + blockP - 1) / blockP) * blockP);
+}
+
 template<class B, class F, class O, class R, class S2>
 template<class S1, class IO1>
 void bi::AdaptivePF<B,F,O,R,S2>::output(const ScheduleElement now,
@@ -0,0 +1,428 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_FILTER_BLOCKPF_HPP
+#define BI_FILTER_BLOCKPF_HPP
+
+#include "BootstrapPF.hpp"
+#include "../state/Mask.hpp"
+#include "../cache/CacheObject.hpp"
+
+#include <vector>
+#include <string>
+
+namespace bi {
+/**
+ * Block particle filter.
+ *
+ * @ingroup method_filter
+ *
+ * @tparam B Model type.
+ * @tparam F Forcer type.
+ * @tparam O Observer type.
+ * @tparam R Resampler type.
+ *
+ * Implements the block particle filter of
+ * @ref Rebeschini2015 "Rebeschini \& van Handel (2015)" for spatial models
+ * of high dimension. The index range of one dimension of the model is
+ * partitioned into contiguous blocks. Each state variable indexed by that
+ * dimension is split across the blocks accordingly, and each observation
+ * indexed by that dimension is assigned to the block in which its
+ * coordinate falls, whether its mask is dense or sparse. Each block then
+ * carries its own weights, which account for the observations of that block
+ * only, and is resampled independently of other blocks, so that the number
+ * of particles required grows with the size of a block rather than with the
+ * dimension of the state.
+ *
+ * Observations and state variables that are not indexed by the blocking
+ * dimension form one further, global block, which is weighted and resampled
+ * in the same way. A block with no state variables has nothing to resample;
+ * its weights are reset when its effective sample size falls below the
+ * threshold, as though it had been resampled. The weights of the particles
+ * as a whole are the sum of the log-weights of all blocks.
+ *
+ * The log-likelihood estimate is the sum of the estimates of each block.
+ * This is biased, in exchange for variance that does not grow exponentially
+ * with dimension. As particles are recombined across blocks on resampling,
+ * they have no common ancestry, so that ancestors are not output, and
+ * sampled paths are not consistent trajectories; the filter is intended for
+ * filtering and likelihood estimation, not smoothing.
+ *
+ * Per-block weights are held by the filter, not the state, so that one
+ * filter object should not be shared between threads.
+ */
+template<class B, class F, class O, class R>
+class BlockPF: public BootstrapPF<B,F,O,R> {
+public:
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param in Forcer.
+   * @param obs Observer.
+   * @param resam Resampler.
+   * @param blockDim Name of dimension along which to partition.
+   * @param blockSize Number of indices of that dimension in each block.
+   */
+  BlockPF(B& m, F& in, O& obs, R& resam, const std::string& blockDim,
+      const int blockSize = 1);
+
+  /**
+   * @name High-level interface
+   *
+   * An easier interface for common usage.
+   */
+  //@{
+  /**
+   * @copydoc BootstrapPF::step()
+   */
+  template<class S1, class IO1>
+  void step(Random& rng, ScheduleIterator& iter, const ScheduleIterator last,
+      S1& s, IO1& out);
+  //@}
+
+  /**
+   * @name Low-level interface
+   *
+   * Largely used by other features of the library or for finer control over
+   * performance and behaviour.
+   */
+  //@{
+  /**
+   * @copydoc BootstrapPF::correct()
+   *
+   * Weights each block by the observations that fall in it.
+   */
+  template<class S1>
+  void correct(Random& rng, const ScheduleElement now, S1& s);
+
+  /**
+   * @copydoc BootstrapPF::resample()
+   *
+   * Resamples each block whose effective sample size is below the
+   * threshold of the resampler.
+   */
+  template<class S1>
+  void resample(Random& rng, const ScheduleElement now, S1& s);
+
+  /**
+   * @copydoc BootstrapPF::term()
+   */
+  template<class S1>
+  void term(S1& s);
+
+  /**
+   * Number of blocks, including the global block.
+   */
+  int getNumBlocks() const;
+  //@}
+
+private:
+  /**
+   * Get observation masks of each block at an observation time.
+   *
+   * @param k Time index.
+   *
+   * @return One mask per block, the last being that of the global block.
+   */
+  const std::vector<Mask<ON_HOST> >& getBlockMasks(const int k);
+
+  /**
+   * Block of each serial coordinate of a variable.
+   *
+   * @param var Variable.
+   * @param ix Serial coordinate.
+   *
+   * @return Block index, or the index of the global block if the variable
+   * is not indexed by the blocking dimension.
+   */
+  int block(const Var* var, const int ix) const;
+
+  /**
+   * Blocking dimension.
+   */
+  Dim* blockDim;
+
+  /**
+   * Number of indices in each block.
+   */
+  int blockSize;
+
+  /**
+   * Number of blocks, including the global block.
+   */
+  int NB;
+
+  /**
+   * Columns of d-vars in each block.
+   */
+  std::vector<std::vector<int> > cols;
+
+  /**
+   * Observation masks of each block, by time index.
+   */
+  CacheObject<std::vector<Mask<ON_HOST> > > blockMasks;
+
+  /**
+   * Log-weights of each block. Rows index particles, columns blocks. A
+   * final column gives their sum, the log-weights of the particles as a
+   * whole.
+   */
+  host_matrix<real> lwb;
+
+  /**
+   * Effective sample size of each block.
+   */
+  host_vector<real> essb;
+
+  /**
+   * Log-likelihood estimate of each block.
+   */
+  host_vector<real> llb;
+};
+}
+
+#include "../math/view.hpp"
+#include "../math/operation.hpp"
+#include "../primitive/vector_primitive.hpp"
+#include "../traits/resampler_traits.hpp"
+
+template<class B, class F, class O, class R>
+bi::BlockPF<B,F,O,R>::BlockPF(B& m, F& in, O& obs, R& resam,
+    const std::string& blockDim, const int blockSize) :
+    BootstrapPF<B,F,O,R>(m, in, obs, resam), blockDim(NULL), blockSize(
+        blockSize) {
+  /* pre-condition */
+  BI_ASSERT(blockSize > 0);
+
+  for (int id = 0; id < m.getNumDims(); ++id) {
+    if (m.getDim(id)->getName().compare(blockDim) == 0) {
+      this->blockDim = m.getDim(id);
+    }
+  }
+  BI_ERROR_MSG(this->blockDim != NULL,
+      "Dimension " << blockDim << " does not exist");
+
+  /* partition d-vars */
+  NB = (this->blockDim->getSize() + blockSize - 1) / blockSize + 1;
+  cols.resize(NB);
+  for (int id = 0; id < m.getNumVars(D_VAR); ++id) {
+    Var* var = m.getVar(D_VAR, id);
+    for (int ix = 0; ix < var->getSize(); ++ix) {
+      cols[block(var, ix)].push_back(var->getStart() + ix);
+    }
+  }
+  essb.resize(NB + 1);
+  llb.resize(NB + 1);
+}
+
+template<class B, class F, class O, class R>
+inline int bi::BlockPF<B,F,O,R>::getNumBlocks() const {
+  return NB;
+}
+
+template<class B, class F, class O, class R>
+template<class S1, class IO1>
+void bi::BlockPF<B,F,O,R>::step(Random& rng, ScheduleIterator& iter,
+    const ScheduleIterator last, S1& s, IO1& out) {
+  do {
+    this->resample(rng, *iter, s);
+    ++iter;
+    this->predict(rng, *iter, s);
+    this->correct(rng, *iter, s);
+    this->output(*iter, s, out);
+  } while (iter + 1 != last && !iter->isObserved());
+}
+
+template<class B, class F, class O, class R>
+template<class S1>
+void bi::BlockPF<B,F,O,R>::correct(Random& rng, const ScheduleElement now,
+    S1& s) {
+  typedef typename S1::temp_vector_type vector_type;
+  typedef typename temp_host_vector<real>::type host_vector_type;
+
+  const int P = s.size();
+
+  if (now.indexTime() == 0 || int(lwb.size1()) != P) {
+    /* start of a new run */
+    lwb.resize(P, NB + 1, false);
+    lwb.clear();
+    llb.clear();
+  }
+
+  if (now.isObserved()) {
+    const std::vector<Mask<ON_HOST> >& masks = getBlockMasks(now.indexObs());
+    vector_type lw(P);
+    host_vector_type lw1(P);
+    double lW, ll = 0.0;
+
+    s.timer.tic();
+    for (int b = 0; b < NB; ++b) {
+      if (masks[b].size() > 0) {
+        Mask<S1::location> mask(masks[b]);
+        lw.clear();
+        this->m.observationLogDensities(s, mask, lw);
+        axpy(1.0, lw, s.logWeights());
+        lw1 = lw;
+        axpy(1.0, lw1, column(lwb, b));
+        axpy(1.0, lw1, column(lwb, NB));
+      }
+    }
+    s.timer.toc(PHASE_OBSERVATION);
+
+    for (int b = 0; b <= NB; ++b) {
+      essb(b) = this->resam.reduce(column(lwb, b), &lW);
+      llb(b) = lW;
+      if (b < NB) {
+        ll += lW;
+      }
+    }
+    s.ess = essb(NB);
+    s.logIncrements(now.indexObs()) = ll - s.logLikelihood;
+    s.logLikelihood = ll;
+    s.timer.toc(PHASE_REDUCE);
+  }
+}
+
+template<class B, class F, class O, class R>
+template<class S1>
+void bi::BlockPF<B,F,O,R>::resample(Random& rng, const ScheduleElement now,
+    S1& s) {
+  typedef typename temp_host_matrix<real>::type host_matrix_type;
+  typedef typename temp_host_matrix<int>::type host_int_matrix_type;
+  typedef typename temp_host_vector<real>::type host_vector_type;
+
+  s.timer.tic();
+  if (now.isObserved()) {
+    const int P = s.size();
+    const double essRel = this->resam.getEssRel();
+    host_int_matrix_type as(P, NB);
+    std::vector<int> bs;
+    bool reset = false;
+
+    /* select ancestors of each block, including the global block, from its
+     * own weights, then reset those weights; a block with no state
+     * variables has no ancestors to select, but its weights are reset all
+     * the same */
+    for (int b = 0; b < NB; ++b) {
+      if (essb(b) < essRel*P) {
+        if (!cols[b].empty()) {
+          typename precompute_type<R,ON_HOST>::type pre;
+          this->resam.precompute(column(lwb, b), pre);
+          this->resam.ancestors(rng, column(lwb, b), column(as, b), pre);
+          bs.push_back(b);
+        }
+        set_elements(column(lwb, b), llb(b));
+        reset = true;
+      }
+    }
+
+    /* copy blocks */
+    if (!bs.empty()) {
+      host_matrix_type X(P, s.get(D_VAR).size2());
+      X = s.get(D_VAR);
+      #pragma omp parallel
+      {
+        host_vector_type x(P);
+        int i, j, p;
+
+        #pragma omp for schedule(dynamic)
+        for (i = 0; i < int(bs.size()); ++i) {
+          const int b = bs[i];
+          for (j = 0; j < int(cols[b].size()); ++j) {
+            x = column(X, cols[b][j]);
+            for (p = 0; p < P; ++p) {
+              X(p, cols[b][j]) = x(as(p, b));
+            }
+          }
+        }
+      }
+      s.get(D_VAR) = X;
+    }
+
+    /* weights of the particles as a whole */
+    if (reset) {
+      column(lwb, NB) = column(lwb, 0);
+      for (int b = 1; b < NB; ++b) {
+        axpy(1.0, column(lwb, b), column(lwb, NB));
+      }
+      s.logWeights() = column(lwb, NB);
+    }
+  }
+  if (now.hasOutput()) {
+    seq_elements(s.ancestors(), 0);
+  }
+  s.timer.toc(PHASE_RESAMPLE);
+}
+
+template<class B, class F, class O, class R>
+template<class S1>
+void bi::BlockPF<B,F,O,R>::term(S1& s) {
+  if (lwb.size1() > 0) {
+    double ll = 0.0;
+    for (int b = 0; b < NB; ++b) {
+      ll += logsumexp_reduce(column(lwb, b)) - bi::log(double(s.size()));
+    }
+    s.logLikelihood = ll;
+  }
+  Simulator<B,F,O>::term(s);
+}
+
+template<class B, class F, class O, class R>
+const std::vector<bi::Mask<bi::ON_HOST> >& bi::BlockPF<B,F,O,R>::getBlockMasks(
+    const int k) {
+  if (!blockMasks.isValid(k)) {
+    const Mask<ON_HOST>& mask = this->obs.getHostMask(k);
+    const int numVars = mask.getNumVars();
+    std::vector<Mask<ON_HOST> > masks(NB, Mask<ON_HOST>(numVars));
+    std::vector<std::vector<int> > ixs(NB);
+    int id, b, i;
+
+    for (id = 0; id < numVars; ++id) {
+      if (mask.isDense(id) || mask.isSparse(id)) {
+        Var* var = this->m.getVar(O_VAR, id);
+
+        /* assign each coordinate to its block */
+        for (b = 0; b < NB; ++b) {
+          ixs[b].clear();
+        }
+        for (i = 0; i < mask.getSize(id); ++i) {
+          const int ix = mask.getIndex(id, i);
+          ixs[block(var, ix)].push_back(ix);
+        }
+
+        for (b = 0; b < NB; ++b) {
+          if (!ixs[b].empty()) {
+            if (mask.isDense(id) && int(ixs[b].size()) == var->getSize()) {
+              masks[b].addDenseMask(id, var->getSize());
+            } else {
+              masks[b].addSparseMask(id, ixs[b].size());
+              BOOST_AUTO(ixs1, masks[b].getIndices(id));
+              for (i = 0; i < int(ixs[b].size()); ++i) {
+                ixs1(i) = ixs[b][i];
+              }
+            }
+          }
+        }
+      }
+    }
+    blockMasks.set(k, masks);
+  }
+  return blockMasks.get(k);
+}
+
+template<class B, class F, class O, class R>
+inline int bi::BlockPF<B,F,O,R>::block(const Var* var, const int ix) const {
+  int d, stride = 1;
+  for (d = 0; d < var->getNumDims(); ++d) {
+    if (var->getDim(d) == blockDim) {
+      return (ix/stride) % blockDim->getSize() / blockSize;
+    }
+    stride *= var->getDim(d)->getSize();
+  }
+  return NB - 1;
+}
+
+#endif
@@ -171,12 +171,15 @@ template<class S1>
 void bi::BootstrapPF<B,F,O,R>::correct(Random& rng, const ScheduleElement now,
     S1& s) {
   if (now.isObserved()) {
+    s.timer.tic();
     this->m.observationLogDensities(s, this->obs.getMask(now.indexObs()),
         s.logWeights());
+    s.timer.toc(PHASE_OBSERVATION);
     double lW;
     s.ess = resam.reduce(s.logWeights(), &lW);
     s.logIncrements(now.indexObs()) = lW - s.logLikelihood;
     s.logLikelihood = lW;
+    s.timer.toc(PHASE_REDUCE);
   }
 }
 
@@ -184,7 +187,13 @@ template<class B, class F, class O, class R>
 template<class S1>
 void bi::BootstrapPF<B,F,O,R>::resample(Random& rng,
     const ScheduleElement now, S1& s) {
-  resam.resample(rng, now, s);
+  s.timer.tic();
+  if (resam.getSort()) {
+    resam.resampleSorted(rng, now, s);
+  } else {
+    resam.resample(rng, now, s);
+  }
+  s.timer.toc(PHASE_RESAMPLE);
 }
 
 template<class B, class F, class O, class R>
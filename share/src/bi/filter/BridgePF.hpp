@@ -117,6 +117,7 @@ void bi::BridgePF<B,F,O,R>::bridge(Random& rng, const ScheduleIterator iter,
     const ScheduleIterator last, S1& s) {
   if (iter->hasBridge() && !iter->isObserved()
       && last->indexObs() > iter->indexObs()) {
+    s.timer.tic();
     axpy(-1.0, s.logAuxWeights(), s.logWeights());
     s.logAuxWeights().clear();
 
@@ -124,11 +125,13 @@ void bi::BridgePF<B,F,O,R>::bridge(Random& rng, const ScheduleIterator iter,
         s.logAuxWeights());
 
     axpy(1.0, s.logAuxWeights(), s.logWeights());
+    s.timer.toc(PHASE_OBSERVATION);
 
     double lW;
     s.ess = this->resam.reduce(s.logWeights(), &lW);
     s.logIncrements(iter->indexObs()) = lW - s.logLikelihood;
     s.logLikelihood = lW;
+    s.timer.toc(PHASE_REDUCE);
   }
 }
 
@@ -0,0 +1,308 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_FILTER_ENSEMBLEKF_HPP
+#define BI_FILTER_ENSEMBLEKF_HPP
+
+#include "../simulator/Simulator.hpp"
+#include "../state/BootstrapPFState.hpp"
+#include "../cache/BootstrapPFCache.hpp"
+#include "../misc/location.hpp"
+#include "../misc/exception.hpp"
+
+namespace bi {
+/**
+ * Ensemble Kalman filter.
+ *
+ * @ingroup method_filter
+ *
+ * @tparam B Model type.
+ * @tparam F Forcer type.
+ * @tparam O Observer type.
+ *
+ * The ensemble is held in the same state as the particles of BootstrapPF,
+ * and is propagated by the same transition, so that neither Jacobians nor
+ * a linearised model are required. At each observation time, the ensemble
+ * is corrected by linear regression on the observations, either with
+ * perturbed observations (the stochastic filter of
+ * @ref Evensen1994 "Evensen (1994)"), or deterministically by a symmetric
+ * square-root transform of the anomalies (the ensemble transform Kalman
+ * filter, ETKF, of @ref Bishop2001 "Bishop et al. (2001)").
+ *
+ * The observation model is used only by simulation. Predicted observations
+ * are drawn twice for each member of the ensemble: the mean of the two
+ * draws serves as the predicted observation, and half their difference
+ * as a draw of the observation noise, from which the variance of that noise
+ * is estimated. Observation noise is assumed additive and uncorrelated
+ * between observations. The analysis is computed in the space of the
+ * ensemble, so that its cost is linear in the number of state variables and
+ * observations, and cubic only in the size of the ensemble.
+ *
+ * The log-likelihood is that of the observations under the Gaussian
+ * approximation implied by the ensemble, and may be used within MarginalMH.
+ * Log-weights remain zero throughout, and the ensemble is never resampled.
+ */
+template<class B, class F, class O>
+class EnsembleKF: public Simulator<B,F,O> {
+public:
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param in Forcer.
+   * @param obs Observer.
+   * @param etkf Use the square-root (ETKF) rather than the stochastic
+   * analysis?
+   */
+  EnsembleKF(B& m, F& in, O& obs, const bool etkf = false);
+
+  /**
+   * @name High-level interface
+   *
+   * An easier interface for common usage.
+   */
+  //@{
+  /**
+   * @copydoc BootstrapPF::step()
+   */
+  template<class S1, class IO1>
+  void step(Random& rng, ScheduleIterator& iter, const ScheduleIterator last,
+      S1& s, IO1& out);
+
+  /**
+   * @copydoc BootstrapPF::samplePath()
+   */
+  template<class S1, class IO1>
+  void samplePath(Random& rng, S1& s, IO1& out);
+  //@}
+
+  /**
+   * @name Low-level interface
+   *
+   * Largely used by other features of the library or for finer control over
+   * performance and behaviour.
+   */
+  //@{
+  /**
+   * Correct ensemble with observations at the current time.
+   *
+   * @tparam S1 State type.
+   *
+   * @param rng Random number generator.
+   * @param now Current step in time schedule.
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void correct(Random& rng, const ScheduleElement now, S1& s);
+
+  /**
+   * Resample. The ensemble is never resampled, but ancestors are set for
+   * output.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param now Current step in time schedule.
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void resample(Random& rng, const ScheduleElement now, S1& s);
+  //@}
+
+private:
+  /**
+   * Use square-root analysis?
+   */
+  bool etkf;
+};
+}
+
+#include "../math/view.hpp"
+#include "../math/operation.hpp"
+#include "../math/constant.hpp"
+#include "../math/loc_temp_vector.hpp"
+#include "../math/loc_temp_matrix.hpp"
+#include "../pdf/misc.hpp"
+#include "../primitive/vector_primitive.hpp"
+#include "../primitive/matrix_primitive.hpp"
+
+template<class B, class F, class O>
+bi::EnsembleKF<B,F,O>::EnsembleKF(B& m, F& in, O& obs, const bool etkf) :
+    Simulator<B,F,O>(m, in, obs), etkf(etkf) {
+  //
+}
+
+template<class B, class F, class O>
+template<class S1, class IO1>
+void bi::EnsembleKF<B,F,O>::samplePath(Random& rng, S1& s, IO1& out) {
+  if (out.size() > 0) {
+    int p = rng.multinomial(out.getLogWeights());
+    out.readPath(p, columns(s.path, 0, out.len));
+    subrange(s.times, 0, out.len) = out.timeCache.get(0, out.len);
+  }
+}
+
+template<class B, class F, class O>
+template<class S1, class IO1>
+void bi::EnsembleKF<B,F,O>::step(Random& rng, ScheduleIterator& iter,
+    const ScheduleIterator last, S1& s, IO1& out) {
+  do {
+    this->resample(rng, *iter, s);
+    ++iter;
+    this->predict(rng, *iter, s);
+    this->correct(rng, *iter, s);
+    this->output(*iter, s, out);
+  } while (iter + 1 != last && !iter->isObserved());
+}
+
+template<class B, class F, class O>
+template<class S1>
+void bi::EnsembleKF<B,F,O>::correct(Random& rng, const ScheduleElement now,
+    S1& s) {
+  typedef typename loc_temp_matrix<S1::location,real>::type matrix_type;
+  typedef typename loc_temp_vector<S1::location,real>::type vector_type;
+  typedef typename loc_temp_vector<S1::location,int>::type int_vector_type;
+
+  if (now.isObserved()) {
+    s.timer.tic();
+    BOOST_AUTO(mask, this->obs.getMask(now.indexObs()));
+    const int P = s.size();
+    const int W = mask.size();
+    const int ND = B::ND;
+
+    /* pre-condition */
+    BI_ERROR_MSG(P > 1,
+        "Ensemble Kalman filter requires at least two members");
+
+    if (W > 0) {
+      matrix_type Y1(P, W), Y2(P, W), S(P, W), X(P, ND), A(P, P), Q(P, P),
+          Qs(P, P), G(P, P);
+      vector_type y(W), z(W), r(W), logr(W), mu(ND), lambda(P), b(P), c(P);
+      int_vector_type map(W);
+
+      /* construct projection from mask */
+      Var* var;
+      int id, start = 0, size;
+      for (id = 0; id < this->m.getNumVars(O_VAR); ++id) {
+        var = this->m.getVar(O_VAR, id);
+        size = mask.getSize(id);
+
+        if (mask.isSparse(id)) {
+          addscal_elements(mask.getIndices(id), var->getStart(),
+              subrange(map, start, size));
+        } else {
+          seq_elements(subrange(map, start, size), var->getStart());
+        }
+        start += size;
+      }
+      gather(map, row(s.get(OY_VAR), 0), y);
+
+      /* two independent draws of predicted observations; their mean, Y1,
+       * is the predicted observation with half the observation noise, and
+       * half their difference, Y2, a draw of the same noise alone */
+      this->observe(rng, s);
+      gather_columns(map, s.get(O_VAR), Y1);
+      this->observe(rng, s);
+      gather_columns(map, s.get(O_VAR), Y2);
+      matrix_axpy(1.0, Y2, Y1);
+      matrix_scal(-2.0, Y2);
+      matrix_axpy(1.0, Y1, Y2);
+      matrix_scal(0.5, Y1);
+      matrix_scal(0.5, Y2);
+
+      /* standard deviation of that noise */
+      dot_columns(Y2, r);
+      scal(1.0 / P, r);
+      BI_ERROR_MSG(amin_reduce(r) > 0.0,
+          "Ensemble Kalman filter requires observation noise of positive "
+          << "variance");
+      sqrt_elements(r, r);
+      log_elements(r, logr);
+
+      /* whitened anomalies of predicted observations */
+      mean(Y1, z);
+      S = Y1;
+      sub_rows(S, z);
+      div_rows(S, r);
+      matrix_scal(1.0 / bi::sqrt(P - 1.0), S);
+
+      /* anomalies of state */
+      X = s.get(D_VAR);
+      mean(X, mu);
+      sub_rows(X, mu);
+
+      /* eigendecomposition of I + SS', from which all else follows */
+      syrk(1.0, S, 0.0, A, 'U');
+      addscal_elements(diagonal(A), 1.0, diagonal(A));
+      try {
+        vector_type work(8 * P), rwork(8 * P);  ///@todo Query for optimal size of work, see LAPACK docs
+        int_vector_type iwork(5 * P), ifail(P);
+        int m;
+
+        syevx('V', 'A', 'U', A, 0.0, 0.0, 0, 0, 0.0, &m, lambda, Q, work,
+            rwork, iwork, ifail);
+      } catch (EigenException e) {
+        BI_ERROR_MSG(false,
+            "Eigendecomposition failed in ensemble Kalman filter");
+      }
+      sqrt_elements(lambda, c);
+      rcp_elements(c, c);
+      gdmm(1.0, c, Q, 0.0, Qs, 'R');
+      log_elements(lambda, lambda);
+
+      /* whitened innovation of mean */
+      sub_elements(y, z, z);
+      div_elements(z, r, z);
+      gemv(1.0, S, z, 0.0, b);
+      gemv(1.0, Qs, b, 0.0, c, 'T');
+
+      /* update log-likelihood, by the matrix determinant lemma and the
+       * Woodbury identity, without forming the covariance of observations */
+      real ll = -0.5 * (dot(z) - dot(c)) - W * BI_HALF_LOG_TWO_PI
+          - sum_reduce(logr) - 0.5 * sum_reduce(lambda);
+      s.logIncrements(now.indexObs()) = ll;
+      s.logLikelihood += ll;
+
+      if (etkf) {
+        /* symmetric square-root transform of anomalies, plus mean update */
+        gemv(1.0, Qs, c, 0.0, b);
+        gemm(1.0, Qs, Q, 0.0, G, 'N', 'T');
+        set_elements(c, 1.0);
+        ger(1.0 / bi::sqrt(P - 1.0), c, b, G);
+      } else {
+        /* whitened innovations of each member, against a single draw of
+         * its predicted observation, with the full observation noise */
+        matrix_axpy(1.0, Y1, Y2);
+        matrix_scal(-1.0, Y2);
+        add_rows(Y2, y);
+        div_rows(Y2, r);
+
+        /* regression of each member on its innovation */
+        gemm(1.0, S, Y2, 0.0, A, 'N', 'T');
+        gemm(1.0, Qs, A, 0.0, G, 'T', 'N');
+        gemm(1.0, Qs, G, 0.0, A);
+        transpose(A, G);
+        matrix_scal(1.0 / bi::sqrt(P - 1.0), G);
+        addscal_elements(diagonal(G), 1.0, diagonal(G));
+      }
+
+      /* apply transform to ensemble */
+      gemm(1.0, G, X, 0.0, s.get(D_VAR));
+      add_rows(s.get(D_VAR), mu);
+    }
+    s.timer.toc(PHASE_OBSERVATION);
+  }
+}
+
+template<class B, class F, class O>
+template<class S1>
+void bi::EnsembleKF<B,F,O>::resample(Random& rng, const ScheduleElement now,
+    S1& s) {
+  if (now.hasOutput()) {
+    seq_elements(s.ancestors(), 0);
+  }
+}
+
+#endif
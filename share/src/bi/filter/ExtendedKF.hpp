@@ -85,6 +85,31 @@ public:
    */
   template<class S1>
   void correct(Random& rng, const ScheduleElement now, S1& s);
+
+  /**
+   * Correct prediction with observations one at a time, using rank-one
+   * downdates of the Cholesky factor rather than refactorisation.
+   *
+   * @param[in,out] mu Predicted mean, corrected on output.
+   * @param[in,out] U Cholesky factor of predicted covariance, corrected on
+   * output.
+   * @param mu3 Mean of observations.
+   * @param R3 Cholesky factor of observation noise covariance. Must be
+   * nonsingular.
+   * @param[in,out] G Jacobian of observations, overwritten on output.
+   * @param y Observations.
+   *
+   * @return Incremental log-likelihood.
+   *
+   * Observations are first whitened by @p R3 so that they are conditionally
+   * independent with unit variance, then incorporated sequentially. This
+   * avoids forming and factorising the covariance of the observations, and
+   * is cheaper than correct() when the number of observations is small
+   * relative to the size of the state.
+   */
+  template<class V1, class M1, class V2, class M2, class M3, class V3>
+  real correctSequential(V1 mu, M1 U, const V2 mu3, const M2 R3, M3 G,
+      const V3 y);
   //@}
 
 protected:
@@ -100,10 +125,14 @@ protected:
 
 #include "../math/view.hpp"
 #include "../math/operation.hpp"
-#include "../math/operation.hpp"
 #include "../math/constant.hpp"
 #include "../math/loc_temp_vector.hpp"
 #include "../math/loc_temp_matrix.hpp"
+#include "../math/sim_temp_vector.hpp"
+#include "../math/sim_temp_matrix.hpp"
+#include "../primitive/vector_primitive.hpp"
+
+#include <limits>
 
 template<class B, class F, class O>
 bi::ExtendedKF<B,F,O>::ExtendedKF(B& m, F& in, O& obs) :
@@ -171,6 +200,9 @@ void bi::ExtendedKF<B,F,O>::predict(Random& rng, const ScheduleElement next,
   /* predict */
   Simulator<B,F,O>::predict(rng, next, s);
 
+  /* covariance prediction is timed as part of the transition */
+  s.timer.tic();
+
   /* predicted mean */
   s.mu1 = row(s.getDyn(), 0);
 
@@ -186,21 +218,21 @@ void bi::ExtendedKF<B,F,O>::predict(Random& rng, const ScheduleElement next,
   subrange(s.U1, 0, NR, NR, ND) = subrange(s.F(), 0, NR, NR, ND);
   trmm(1.0, subrange(s.U1, 0, NR, 0, NR), subrange(s.U1, 0, NR, NR, ND));
 
-  /* predicted covariance */
-  matrix_type Sigma(M, M);
-  Sigma.clear();
-  syrk(1.0, s.C, 0.0, Sigma, 'U', 'T');
-  syrk(1.0, s.U1, 1.0, Sigma, 'U', 'T');
+  /* stacked square-root factors of predicted covariance */
+  matrix_type A(M + NR, M);
+  rows(A, 0, M) = s.C;
+  rows(A, M, NR) = rows(s.U1, 0, NR);
 
   /* across-time covariance */
   trmm(1.0, s.U2, s.C, 'L', 'U', 'T');
 
-  /* Cholesky factor of predicted covariance */
-  chol(Sigma, s.U1);
+  /* Cholesky factor of predicted covariance, without forming it */
+  tria(A, s.U1);
 
   /* reset Jacobian, as it has now been multiplied in */
   ident(s.F());
   s.Q().clear();
+  s.timer.toc(PHASE_TRANSITION);
 }
 
 template<class B, class F, class O>
@@ -215,12 +247,13 @@ void bi::ExtendedKF<B,F,O>::correct(Random& rng, const ScheduleElement now,
   s.U2 = s.U1;
 
   if (now.isObserved()) {
+    s.timer.tic();
     BOOST_AUTO(mask, this->obs.getMask(now.indexObs()));
     const int W = mask.size();
 
     this->observe(rng, s);
 
-    matrix_type C(M, W), U3(W, W), Sigma3(W, W), R3(W, W);
+    matrix_type C(M, W), U3(W, W), R3(W, W);
     vector_type y(W), z(W), mu3(W);
     int_vector_type map(W);
 
@@ -246,33 +279,115 @@ void bi::ExtendedKF<B,F,O>::correct(Random& rng, const ScheduleElement now,
     gather(map, row(s.get(O_VAR), 0), mu3);
     gather(map, row(s.get(OY_VAR), 0), y);
 
-    trmm(1.0, s.U1, C);
-
-    Sigma3.clear();
-    syrk(1.0, C, 0.0, Sigma3, 'U', 'T');
-    syrk(1.0, R3, 1.0, Sigma3, 'U', 'T');
-    trmm(1.0, s.U1, C, 'L', 'U', 'T');
-    chol(Sigma3, U3, 'U');
-
-    /* update marginal log-likelihood */
-    ///@todo Duplicates some operations in condition() calls below
-    sub_elements(y, mu3, z);
-    trsv(U3, z, 'U');
-    s.logLikelihood += -0.5 * dot(z) - BI_HALF_LOG_TWO_PI
-        - bi::log(prod_reduce(diagonal(U3)));
-
-    if (now.indexTime() > 0) {
-      condition(s.mu2, s.U2, mu3, U3, C, y);
+    if (now.indexTime() > 0 && W <= M && amin_reduce(diagonal(R3)) > 0.0) {
+      /* sparse observations, incorporate one at a time */
+      s.logLikelihood += correctSequential(s.mu2, s.U2, mu3, R3, C, y);
     } else {
-      condition(subrange(s.mu2, NR, ND), subrange(s.U2, NR, ND, NR, ND), mu3,
-          U3, rows(C, NR, ND), y);
+      /* stacked square-root factors of observation covariance */
+      matrix_type A(M + W, W);
+      trmm(1.0, s.U1, C);
+      rows(A, 0, M) = C;
+      rows(A, M, W) = R3;
+      trmm(1.0, s.U1, C, 'L', 'U', 'T');
+      tria(A, U3);
+
+      /* update marginal log-likelihood */
+      ///@todo Duplicates some operations in condition() calls below
+      sub_elements(y, mu3, z);
+      trsv(U3, z, 'U', 'T');
+      s.logLikelihood += -0.5 * dot(z) - W * BI_HALF_LOG_TWO_PI
+          - bi::log(prod_reduce(diagonal(U3)));
+
+      if (now.indexTime() > 0) {
+        condition(s.mu2, s.U2, mu3, U3, C, y);
+      } else {
+        condition(subrange(s.mu2, NR, ND), subrange(s.U2, NR, ND, NR, ND),
+            mu3, U3, rows(C, NR, ND), y);
+      }
     }
     row(s.getDyn(), 0) = s.mu2;
 
     /* reset Jacobian */
     s.G().clear();
     s.R().clear();
+    s.timer.toc(PHASE_OBSERVATION);
+  }
+}
+
+template<class B, class F, class O>
+template<class V1, class M1, class V2, class M2, class M3, class V3>
+real bi::ExtendedKF<B,F,O>::correctSequential(V1 mu, M1 U, const V2 mu3,
+    const M2 R3, M3 G, const V3 y) {
+  /* pre-conditions */
+  BI_ASSERT(U.size1() == mu.size() && U.size2() == mu.size());
+  BI_ASSERT(R3.size1() == mu3.size() && R3.size2() == mu3.size());
+  BI_ASSERT(G.size1() == mu.size() && G.size2() == mu3.size());
+  BI_ASSERT(y.size() == mu3.size());
+
+  typedef typename sim_temp_vector<V1>::type vector_type;
+  typedef typename sim_temp_matrix<M1>::type matrix_type;
+
+  const int N = mu.size();
+  const int W = mu3.size();
+  vector_type z(W), a(N), b(N), c(N);
+  real r, v, ll;
+  int j;
+
+  /* whiten observations */
+  sub_elements(y, mu3, z);
+  trsv(R3, z, 'U', 'T');
+  trsm(1.0, R3, G, 'R', 'U');
+  ll = -bi::log(prod_reduce(diagonal(R3)));
+
+  for (j = 0; j < W; ++j) {
+    /* innovation variance and cross-covariance */
+    a = column(G, j);
+    trmv(U, a);
+    c = a;
+    trmv(U, c, 'U', 'T');
+    v = dot(a) + 1.0;
+    r = z(j);
+
+    /* update marginal log-likelihood */
+    ll += -0.5 * r * r / v - BI_HALF_LOG_TWO_PI - 0.5 * bi::log(v);
+
+    /* update mean, and innovations of remaining observations */
+    axpy(r / v, c, mu);
+    if (j + 1 < W) {
+      gemv(-r / v, columns(G, j + 1, W - j - 1), c, 1.0,
+          subrange(z, j + 1, W - j - 1), 'T');
+    }
+
+    /* rank-one downdate of Cholesky factor */
+    axpy(1.0 / bi::sqrt(v), c, a, true);
+    try {
+      ch1dn(U, a, b);
+    } catch (CholeskyException e) {
+      /* downdate lost positive definiteness through round-off, so
+       * refactorise with jitter on the diagonal, increased until the
+       * factorisation succeeds, and otherwise give up */
+      matrix_type Sigma(N, N);
+      Sigma.clear();
+      syrk(1.0, U, 0.0, Sigma, 'U', 'T');
+      syr(-1.0 / v, c, Sigma, 'U');
+
+      real eps = std::numeric_limits<real>::epsilon()
+          * bi::max(sum_reduce(diagonal(Sigma)) / N, BI_REAL(1.0));
+      for (int k = 0;; ++k) {
+        addscal_elements(diagonal(Sigma), eps, diagonal(Sigma));
+        try {
+          chol(Sigma, U, 'U');
+          break;
+        } catch (CholeskyException e) {
+          if (k >= 6) {
+            throw e;
+          }
+          eps *= 10.0;
+        }
+      }
+    }
   }
+  return ll;
 }
 
 #endif
@@ -50,6 +50,31 @@ public:
   void filter(Random& rng, const ScheduleIterator first,
       const ScheduleIterator last, S1& s, IO1& out, TicToc& clock,
       const long deadline);
+
+  /**
+   * Resume filtering over an extended time schedule.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Position in the extended time schedule at which a previous
+   * call to filter() or resume() finished, i.e. the element corresponding to
+   * the last element of the previous schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   * @param[out] out Output buffer.
+   *
+   * The state and output buffer must be those of the previous call,
+   * extended as necessary to the sizes of the new time schedule (see
+   * FilterState::extend()). Neither is reinitialised, only the steps after
+   * @p first are taken, and the marginal log-likelihood accumulates from its
+   * previous value. This supports online filtering, where observations
+   * arrive incrementally and the time schedule is rebuilt to include them.
+   */
+  template<class S1, class IO1>
+  void resume(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, IO1& out);
 };
 }
 
@@ -59,6 +84,7 @@ void bi::Filter<F>::filter(Random& rng, const ScheduleIterator first,
     const ScheduleIterator last, S1& s, IO1& out) {
   TicToc clock;
   ScheduleIterator iter = first;
+  s.timer.reset();
   this->output0(s, out);
   this->correct(rng, *iter, s);
   this->output(*iter, s, out);
@@ -76,6 +102,7 @@ void bi::Filter<F>::filter(Random& rng, const ScheduleIterator first,
     const ScheduleIterator last, S1& s, IO1& out, TicToc& clock, const long deadline) {
   long start = clock.toc();
   ScheduleIterator iter = first;
+  s.timer.reset();
   if (clock.toc() < deadline) {
     this->output0(s, out);
     this->correct(rng, *iter, s);
@@ -91,4 +118,21 @@ void bi::Filter<F>::filter(Random& rng, const ScheduleIterator first,
   }
 }
 
+template<class F>
+template<class S1, class IO1>
+void bi::Filter<F>::resume(Random& rng, const ScheduleIterator first,
+    const ScheduleIterator last, S1& s, IO1& out) {
+  /* pre-condition */
+  BI_ASSERT(first->getTime() == s.getTime());
+
+  TicToc clock;
+  ScheduleIterator iter = first;
+  while (iter + 1 != last) {
+    this->step(rng, iter, last, s, out);
+  }
+  this->term(s);
+  s.clock += clock.toc();
+  this->outputT(s, out);
+}
+
 #endif
@@ -10,8 +10,10 @@
 #include "BootstrapPF.hpp"
 #include "LookaheadPF.hpp"
 #include "BridgePF.hpp"
+#include "BlockPF.hpp"
 #include "AdaptivePF.hpp"
 #include "ExtendedKF.hpp"
+#include "EnsembleKF.hpp"
 
 namespace bi {
 /**
@@ -42,13 +44,21 @@ public:
   static boost::shared_ptr<Filter<BridgePF<B,F,O,R> > > createBridgePF(B& m,
       F& in, O& obs, R& resam);
 
+  /**
+   * Create block particle filter.
+   */
+  template<class B, class F, class O, class R>
+  static boost::shared_ptr<Filter<BlockPF<B,F,O,R> > > createBlockPF(B& m,
+      F& in, O& obs, R& resam, const std::string& blockDim,
+      const int blockSize = 1);
+
   /**
    * Create adaptive particle filter.
    */
   template<class B, class F, class O, class R, class S2>
   static boost::shared_ptr<Filter<AdaptivePF<B,F,O,R,S2> > > createAdaptivePF(
       B& m, F& in, O& obs, R& resam, S2& stopper, const int initialP,
-      const int blockP);
+      const int blockP, const double budget = 0.0);
 
   /**
    * Create extended Kalman filter.
@@ -56,6 +66,13 @@ public:
   template<class B, class F, class O>
   static boost::shared_ptr<Filter<ExtendedKF<B,F,O> > > createExtendedKF(B& m,
       F& in, O& obs);
+
+  /**
+   * Create ensemble Kalman filter.
+   */
+  template<class B, class F, class O>
+  static boost::shared_ptr<Filter<EnsembleKF<B,F,O> > > createEnsembleKF(B& m,
+      F& in, O& obs, const bool etkf = false);
 };
 }
 
@@ -80,12 +97,20 @@ boost::shared_ptr<bi::Filter<bi::BridgePF<B,F,O,R> > > bi::FilterFactory::create
   return boost::shared_ptr<T>(new T(m, in, obs, resam));
 }
 
+template<class B, class F, class O, class R>
+boost::shared_ptr<bi::Filter<bi::BlockPF<B,F,O,R> > > bi::FilterFactory::createBlockPF(
+    B& m, F& in, O& obs, R& resam, const std::string& blockDim,
+    const int blockSize) {
+  typedef Filter<BlockPF<B,F,O,R> > T;
+  return boost::shared_ptr<T>(new T(m, in, obs, resam, blockDim, blockSize));
+}
+
 template<class B, class F, class O, class R, class S2>
 boost::shared_ptr<bi::Filter<bi::AdaptivePF<B,F,O,R,S2> > > bi::FilterFactory::createAdaptivePF(
     B& m, F& in, O& obs, R& resam, S2& stopper, const int initialP,
-    const int blockP) {
+    const int blockP, const double budget) {
   typedef Filter<AdaptivePF<B,F,O,R,S2> > T;
-  return boost::shared_ptr<T>(new T(m, in, obs, resam, stopper, initialP, blockP));
+  return boost::shared_ptr<T>(new T(m, in, obs, resam, stopper, initialP, blockP, budget));
 }
 
 template<class B, class F, class O>
@@ -95,4 +120,11 @@ boost::shared_ptr<bi::Filter<bi::ExtendedKF<B,F,O> > > bi::FilterFactory::create
   return boost::shared_ptr<T>(new T(m, in, obs));
 }
 
+template<class B, class F, class O>
+boost::shared_ptr<bi::Filter<bi::EnsembleKF<B,F,O> > > bi::FilterFactory::createEnsembleKF(
+    B& m, F& in, O& obs, const bool etkf) {
+  typedef Filter<EnsembleKF<B,F,O> > T;
+  return boost::shared_ptr<T>(new T(m, in, obs, etkf));
+}
+
 #endif
@@ -23,6 +23,27 @@ public:
   template<class V1>
   static int prune(V1& as, V1& os, V1& ls);
 
+  /**
+   * Truncate ancestry tree.
+   *
+   * @tparam V1 Integer vector type.
+   * @tparam V2 Integer vector type.
+   *
+   * @param as Ancestors.
+   * @param os Offspring.
+   * @param gs Generations.
+   * @param rs Nodes of generation @p g, some of which may since have been
+   * removed.
+   * @param g Generation at which to truncate.
+   *
+   * Surviving nodes of generation @p g become roots, and all older nodes are
+   * removed.
+   *
+   * @return Number of nodes removed.
+   */
+  template<class V1, class V2>
+  static int truncate(V1& as, V1& os, V1& gs, const V2 rs, const int g);
+
   /**
    * Insert into ancestry tree.
    *
@@ -74,6 +95,33 @@ int bi::AncestryCacheHost::prune(V1& as, V1& os, V1& ls) {
   return numRemoved;
 }
 
+template<class V1, class V2>
+int bi::AncestryCacheHost::truncate(V1& as, V1& os, V1& gs, const V2 rs,
+    const int g) {
+  /* pre-condition */
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+
+  int i, j, r, numRemoved = 0;
+  for (i = 0; i < rs.size(); ++i) {
+    r = rs(i);
+    if (gs(r) == g && os(r) > 0) {
+      /* node survives, and has not been replaced by a younger one */
+      j = as(r);
+      as(r) = -1;
+      while (j >= 0) {
+        --os(j);
+        if (os(j) > 0) {
+          break;
+        }
+        ++numRemoved;
+        j = as(j);
+      }
+    }
+  }
+  return numRemoved;
+}
+
 template<class M1, class V1, class M2, class V2>
 int bi::AncestryCacheHost::insert(M1& X, V1& as, V1& os, V1& ls, const int start,
     const M2 X1, const V2 as1) {
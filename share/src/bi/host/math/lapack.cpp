@@ -12,3 +12,4 @@
 LAPACK_FUNC_DEF(potrf, dpotrf, spotrf)
 LAPACK_FUNC_DEF(potrs, dpotrs, spotrs)
 LAPACK_FUNC_DEF(syevx, dsyevx, ssyevx)
+LAPACK_FUNC_DEF(geqrf, dgeqrf, sgeqrf)
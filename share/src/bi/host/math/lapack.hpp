@@ -23,6 +23,10 @@ void dsyevx_(char* jobz, char* range, char* uplo, int* N, double* A, int* ldA,
     double* vl, double* vu, int* il, int* iu, double* abstol, int* m,
     double* w, double* Z, int* ldZ, double* work, int* lwork, int* iwork,
     int* ifail, int* info);
+void sgeqrf_(int* m, int* n, float* A, int* lda, float* tau, float* work,
+    int* lwork, int* info);
+void dgeqrf_(int* m, int* n, double* A, int* lda, double* tau, double* work,
+    int* lwork, int* info);
 }
 
 #include "boost/typeof/typeof.hpp"
@@ -51,5 +55,6 @@ namespace bi { \
 LAPACK_FUNC(potrf, dpotrf, spotrf)
 LAPACK_FUNC(potrs, dpotrs, spotrs)
 LAPACK_FUNC(syevx, dsyevx, ssyevx)
+LAPACK_FUNC(geqrf, dgeqrf, sgeqrf)
 
 #endif
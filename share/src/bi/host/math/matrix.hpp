@@ -372,9 +372,18 @@ void bi::host_matrix_handle<T,size1_value,size2_value,lead_value,inc_value>::loa
   ar & rows & cols;
   BI_ASSERT(this->size1() == rows && this->size2() == cols);
 
-  for (j = 0; j < cols; ++j) {
-    for (i = 0; i < rows; ++i) {
-      ar & (*this)(i, j);
+  if (this->contiguous()) {
+    ar & boost::serialization::make_array(this->buf(), rows * cols);
+  } else if (this->inc() == 1) {
+    for (j = 0; j < cols; ++j) {
+      ar & boost::serialization::make_array(this->buf() + j * this->lead(),
+          rows);
+    }
+  } else {
+    for (j = 0; j < cols; ++j) {
+      for (i = 0; i < rows; ++i) {
+        ar & (*this)(i, j);
+      }
     }
   }
 }
@@ -387,9 +396,18 @@ void bi::host_matrix_handle<T,size1_value,size2_value,lead_value,inc_value>::sav
   size_type rows = this->size1(), cols = this->size2(), i, j;
   ar & rows & cols;
 
-  for (j = 0; j < cols; ++j) {
-    for (i = 0; i < rows; ++i) {
-      ar & (*this)(i, j);
+  if (this->contiguous()) {
+    ar & boost::serialization::make_array(this->buf(), rows * cols);
+  } else if (this->inc() == 1) {
+    for (j = 0; j < cols; ++j) {
+      ar & boost::serialization::make_array(this->buf() + j * this->lead(),
+          rows);
+    }
+  } else {
+    for (j = 0; j < cols; ++j) {
+      for (i = 0; i < rows; ++i) {
+        ar & (*this)(i, j);
+      }
     }
   }
 }
@@ -103,7 +103,7 @@ void bi::multi_ch1dn_impl<bi::ON_HOST,T1>::func(const int P, M1 Us, V1 as, V2 bs
     typename sim_temp_vector<V2>::type b(as.size()/P);
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       multi_get_matrix(P, Us, p, U);
       multi_get_vector(P, as, p, a);
@@ -129,7 +129,7 @@ void bi::multi_gemv_impl<bi::ON_HOST,T1>::func(const int P, const T1 alpha,
     typename sim_temp_vector<V2>::type y(ys.size()/P);
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       multi_get_matrix(P, As, p, A);
       multi_get_vector(P, xs, p, x);
@@ -155,7 +155,7 @@ void bi::multi_gemm_impl<bi::ON_HOST,T1>::func(const int P,
     typename sim_temp_matrix<M2>::type Y(Ys.size1()/P, Ys.size2());
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       multi_get_matrix(P, As, p, A);
       multi_get_matrix(P, Xs, p, X);
@@ -179,7 +179,7 @@ void bi::multi_trmm_impl<bi::ON_HOST,T1>::func(const int P,
     typename sim_temp_matrix<M2>::type B(Bs.size1()/P, Bs.size2());
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       multi_get_matrix(P, As, p, A);
       multi_get_matrix(P, Bs, p, B);
@@ -201,7 +201,7 @@ void bi::multi_syrk_impl<bi::ON_HOST,T1>::func(const int P, const T1 alpha,
     typename sim_temp_matrix<M2>::type C(Cs.size1()/P, Cs.size2());
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       multi_get_matrix(P, As, p, A);
       multi_get_matrix(P, Cs, p, C);
@@ -223,7 +223,7 @@ void bi::multi_trsv_impl<bi::ON_HOST,T1>::func(const int P, const M1 As, V1 xs,
     typename sim_temp_vector<V1>::type x(xs.size()/P);
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       multi_get_matrix(P, As, p, A);
       multi_get_vector(P, xs, p, x);
@@ -246,7 +246,7 @@ void bi::multi_trsm_impl<bi::ON_HOST,T1>::func(const int P,
     typename sim_temp_matrix<M2>::type X(Xs.size1()/P, Xs.size2());
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       multi_get_matrix(P, As, p, A);
       multi_get_matrix(P, Xs, p, X);
@@ -269,7 +269,7 @@ void bi::multi_potrf_impl<bi::ON_HOST,T1>::func(const int P, M1 Us,
     typename sim_temp_matrix<M1>::type U(Us.size1()/P, Us.size2());
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       multi_get_matrix(P, Us, p, U);
 
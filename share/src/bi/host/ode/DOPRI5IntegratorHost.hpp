@@ -61,7 +61,7 @@ void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
     bool k1in;
     PX pax;
 
-#pragma omp for
+#pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       t = t1;
       h = h_h0;
@@ -64,7 +64,7 @@ void bi::RK43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
     int n, id, p;
     PX pax;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; ++p) {
       t = t1;
       h = h_h0;
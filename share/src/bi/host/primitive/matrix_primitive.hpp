@@ -7,6 +7,15 @@
 #define BI_HOST_PRIMITIVE_MATRIXPRIMITIVE_HPP
 
 namespace bi {
+/**
+ * @internal
+ */
+template<>
+struct clear_rows_impl<ON_HOST> {
+  template<class M1>
+  static void func(M1 X);
+};
+
 /**
  * @internal
  */
@@ -62,15 +71,38 @@ struct scatter_matrix_impl<ON_HOST> {
 };
 }
 
+template<class M1>
+void bi::clear_rows_impl<bi::ON_HOST>::func(M1 X) {
+  #pragma omp parallel
+  {
+    int i, j;
+
+    for (j = 0; j < X.size2(); ++j) {
+      #pragma omp for schedule(static) nowait
+      for (i = 0; i < X.size1(); ++i) {
+        X(i, j) = 0;
+      }
+    }
+  }
+}
+
 template<class V1, class M1, class M2>
 void bi::gather_rows_impl<bi::ON_HOST>::func(const V1 map, const M1 X, M2 Y) {
-  for (int j = 0; j < X.size2(); ++j) {
-    //bi::gather(map, column(X, j), column(Y, j));
-    //^ causes segfault with Intel compiler (?)
-    for (int i = 0; i < map.size(); ++i) {
-      Y(i, j) = X(map(i), j);
-    }
+  /* rows of Y are partitioned between threads as for updaters, so that
+   * each thread writes the particles it owns; the same partition is used
+   * for all columns, so no barrier is required between them */
+  #pragma omp parallel
+  {
+    int i, j;
 
+    for (j = 0; j < X.size2(); ++j) {
+      //bi::gather(map, column(X, j), column(Y, j));
+      //^ causes segfault with Intel compiler (?)
+      #pragma omp for schedule(static) nowait
+      for (i = 0; i < map.size(); ++i) {
+        Y(i, j) = X(map(i), j);
+      }
+    }
   }
 }
 
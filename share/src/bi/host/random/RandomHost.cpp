@@ -12,16 +12,22 @@
 void bi::RandomHost::seeds(Random& rng, const unsigned seed) {
   #pragma omp parallel
   {
-    #ifdef ENABLE_MPI
-    boost::mpi::communicator world;
-    const int rank = world.rank();
-    const int size = world.size();
+    rng.getHostRng().seed(stream(seed, bi_omp_tid));
+  }
+}
 
-    int s = seed*size*bi_omp_max_threads + rank*bi_omp_max_threads + bi_omp_tid;
-    #else
-    int s = seed*bi_omp_max_threads + bi_omp_tid;
-    #endif
+void bi::RandomHost::resetCommon(Random& rng, const unsigned seed) {
+  rng.getHostRng().seed(stream(seed, 0));
+}
 
-    rng.getHostRng().seed(s);
-  }
+int bi::RandomHost::stream(const unsigned seed, const int tid) {
+  #ifdef ENABLE_MPI
+  boost::mpi::communicator world;
+  const int rank = world.rank();
+  const int size = world.size();
+
+  return seed*size*bi_omp_max_threads + rank*bi_omp_max_threads + tid;
+  #else
+  return seed*bi_omp_max_threads + tid;
+  #endif
 }
@@ -22,6 +22,13 @@ struct RandomHost {
    */
   static void seeds(Random& rng, const unsigned seed);
 
+  /**
+   * @copydoc Random::resetCommon
+   *
+   * @param seed Seed given to seeds().
+   */
+  static void resetCommon(Random& rng, const unsigned seed);
+
   /**
    * @copydoc Random::uniforms
    */
@@ -70,6 +77,15 @@ struct RandomHost {
    */
   template<class V1, class V2>
   static void multinomials(Random& rng, const V1 lps, V2 xs);
+
+private:
+  /**
+   * Seed for the stream of a thread.
+   *
+   * @param seed Seed given to seeds().
+   * @param tid Thread number.
+   */
+  static int stream(const unsigned seed, const int tid);
 };
 }
 
@@ -7,6 +7,7 @@
 #define BI_HOST_RANDOM_RNG_HPP
 
 #include "boost/random/mersenne_twister.hpp"
+#include "boost/serialization/split_member.hpp"
 
 namespace bi {
 /**
@@ -15,7 +16,10 @@ namespace bi {
  * @ingroup math_rng
  *
  * Uses the Mersenne Twister algorithm for generating pseudorandom variates,
- * as implemented in Boost.Random.
+ * as implemented in Boost.Random. Gamma, Poisson and binomial variates use
+ * the rejection samplers of rejection.hpp rather than the distributions of
+ * Boost.Random, as their parameters typically change from one variate to
+ * the next, and the latter precompute for a fixed parameter.
  *
  * @section RngHost_references References
  *
@@ -84,22 +88,43 @@ public:
    * Random number generator.
    */
   rng_type rng;
+
+private:
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
 };
 }
 
 #include "../../misc/omp.hpp"
 #include "../../math/sim_temp_vector.hpp"
+#include "../../random/rejection.hpp"
 
 #include "boost/random/uniform_int.hpp"
 #include "boost/random/uniform_real.hpp"
 #include "boost/random/normal_distribution.hpp"
 #include "boost/random/gamma_distribution.hpp"
-#include "boost/random/binomial_distribution.hpp"
-#include "boost/random/poisson_distribution.hpp"
 #include "boost/random/variate_generator.hpp"
 
 #include "thrust/binary_search.h"
 
+#include <sstream>
+#include <string>
+
 inline void bi::RngHost::seed(const unsigned seed) {
   rng.seed(seed);
 }
@@ -170,12 +195,10 @@ inline T1 bi::RngHost::gamma(const T1 alpha, const T1 beta) {
   BI_ASSERT(alpha > 0.0);
   BI_ASSERT(beta > 0.0);
 
-  typedef boost::gamma_distribution<T1> dist_type;
-
-  dist_type dist(alpha);
-  boost::variate_generator<rng_type&, dist_type> gen(rng, dist);
+  gamma_rejection<T1> g;
+  g.init(alpha, beta);
 
-  return beta*gen();
+  return rejection_sample(*this, g);
 }
 
 template<class T1>
@@ -183,17 +206,14 @@ inline T1 bi::RngHost::poisson(const T1 lambda) {
   /* pre-condition */
   BI_ASSERT(lambda >= 0.0);
 
-  if (lambda > 0) {
-    typedef boost::poisson_distribution<int,T1> dist_type;
-
-    dist_type dist(lambda);
-    boost::variate_generator<rng_type&, dist_type> gen(rng, dist);
-
-    return static_cast<T1>(gen());
+  if (lambda < static_cast<T1>(10.0)) {
+    return poisson_inversion(*this, lambda);
   } else {
-    return 0;
-  }
+    poisson_rejection<T1> g;
+    g.init(lambda);
 
+    return rejection_sample(*this, g);
+  }
 }
 
 template<class T1, class T2>
@@ -203,12 +223,31 @@ inline T1 bi::RngHost::binomial(const T1 n, const T2 p) {
   BI_ASSERT(p >= static_cast<T2>(0.0));
   BI_ASSERT(p <= static_cast<T2>(1.0));
 
-  typedef boost::binomial_distribution<int,T2> dist_type;
+  const T1 p1 = static_cast<T1>(p);
+  if (n*bi::min(p1, static_cast<T1>(1.0) - p1) < static_cast<T1>(10.0)) {
+    return binomial_inversion(*this, n, p1);
+  } else {
+    binomial_rejection<T1> g;
+    g.init(n, p1);
 
-  dist_type dist(n, p);
-  boost::variate_generator<rng_type&, dist_type> gen(rng, dist);
+    return rejection_sample(*this, g);
+  }
+}
+
+template<class Archive>
+void bi::RngHost::save(Archive& ar, const unsigned version) const {
+  std::ostringstream buf;
+  buf << rng;
+  std::string str(buf.str());
+  ar & str;
+}
 
-  return static_cast<T1>(gen());
+template<class Archive>
+void bi::RngHost::load(Archive& ar, const unsigned version) {
+  std::string str;
+  ar & str;
+  std::istringstream buf(str);
+  buf >> rng;
 }
 
 #endif
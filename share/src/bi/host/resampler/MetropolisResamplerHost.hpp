@@ -39,7 +39,7 @@ void bi::MetropolisResamplerHost::ancestors(Random& rng, const V1 lws,
     real alpha, lw1, lw2;
     int k, p1, p2, p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P2; ++p) {
       p1 = p;
       lw1 = lws(p);
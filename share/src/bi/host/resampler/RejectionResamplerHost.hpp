@@ -48,7 +48,7 @@ void bi::RejectionResamplerHost::ancestors(Random& rng, const V1 lws,
     real alpha, lw2;
     int p, p2;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P2; ++p) {
       /* first proposal */
       if (p < P2/P1*P1) {
@@ -117,7 +117,7 @@ void bi::ResamplerHost::cumulativeOffspringToAncestors(const V1 Os, V2 as) {
   {
     int i, j, O1, O2, o;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (int i = 0; i < Os.size(); ++i) {
       O1 = (i > 0) ? Os(i - 1) : 0;
       O2 = Os(i);
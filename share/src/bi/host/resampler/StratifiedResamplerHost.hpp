@@ -56,14 +56,14 @@ void bi::StratifiedResamplerHost::op(Random& rng, const V1 Ws, V2 Os,
     dist_type dist(0.0, 1.0);
     boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (i = 0; i < alphas.size(); ++i) {
       alphas(i) = gen();
     }
 
     #pragma omp barrier
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (i = 0; i < Ws.size(); ++i) {
       T1 reach = Ws(i)/W*n;
       int k = bi::min(n - 1, static_cast<int>(reach));
@@ -60,7 +60,7 @@ void bi::DynamicLogDensityHost<B,S>::logDensities(const T1 t1, const T1 t2,
     OX x;
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(t1, t2, s, p, pax, x, lp(p));
     }
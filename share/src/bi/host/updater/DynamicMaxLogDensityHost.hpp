@@ -58,7 +58,7 @@ void bi::DynamicMaxLogDensityHost<B,S>::maxLogDensities(const T1 t1,
     OX x;
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(t1, t2, s, p, pax, x, lp(p));
     }
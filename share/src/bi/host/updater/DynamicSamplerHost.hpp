@@ -63,7 +63,7 @@ void bi::DynamicSamplerHost<B,S>::samples(Random& rng, const T1 t1,
     R1& rng1 = rng.getHostRng();
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(rng1, t1, t2, s, p, pax, x);
     }
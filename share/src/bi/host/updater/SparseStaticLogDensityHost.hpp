@@ -54,15 +54,21 @@ void bi::SparseStaticLogDensityHost<B,S>::logDensities(State<B,ON_HOST>& s,
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
+  /* observation-major over tiles of trajectories: the tile of log-densities
+   * stays in cache across observations, and the inner loop over the
+   * trajectories of a tile reads the state with unit stride */
+  static const int TILE = 256;
+  const int P = s.size();
+
   #pragma omp parallel
   {
     PX pax;
     OX x;
-    int p;
+    int start;
 
-    #pragma omp for
-    for (p = 0; p < s.size(); ++p) {
-      Visitor::accept(mask, s, p, pax, x, lp(p));
+    #pragma omp for schedule(static)
+    for (start = 0; start < P; start += TILE) {
+      Visitor::accept(mask, s, start, bi::min(start + TILE, P), pax, x, lp);
     }
   }
 }
@@ -16,6 +16,14 @@ public:
   template<class T1>
   static void accept(State<B,ON_HOST>& s, const Mask<ON_HOST>& mask,
       const int p, const PX& pax, OX& x, T1& lp);
+
+  /**
+   * Visit a range of trajectories. Matrix expressions are evaluated for
+   * each trajectory in turn.
+   */
+  template<class V1>
+  static void accept(const Mask<ON_HOST>& mask, State<B,ON_HOST>& s,
+      const int start, const int end, const PX& pax, OX& x, V1 lp);
 };
 
 /**
@@ -31,6 +39,12 @@ public:
       const int p, const PX& pax, OX& x, T1& lp) {
     //
   }
+
+  template<class V1>
+  static void accept(const Mask<ON_HOST>& mask, State<B,ON_HOST>& s,
+      const int start, const int end, const PX& pax, OX& x, V1 lp) {
+    //
+  }
 };
 }
 
@@ -58,4 +72,14 @@ void bi::SparseStaticLogDensityMatrixVisitorHost<B,S,PX,OX>::accept(
       p, pax, x, lp);
 }
 
+template<class B, class S, class PX, class OX>
+template<class V1>
+void bi::SparseStaticLogDensityMatrixVisitorHost<B,S,PX,OX>::accept(
+    const Mask<ON_HOST>& mask, State<B,ON_HOST>& s, const int start,
+    const int end, const PX& pax, OX& x, V1 lp) {
+  for (int p = start; p < end; ++p) {
+    accept(s, mask, p, pax, x, lp(p));
+  }
+}
+
 #endif
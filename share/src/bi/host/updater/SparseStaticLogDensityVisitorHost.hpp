@@ -16,6 +16,15 @@ public:
   template<class T1>
   static void accept(const Mask<ON_HOST>& mask, State<B,ON_HOST>& s,
       const int p, const PX& pax, OX& x, T1& lp);
+
+  /**
+   * Visit a range of trajectories, observation-major: each masked element
+   * is visited once, with an inner loop over the trajectories of the
+   * range, so that the state is read with unit stride.
+   */
+  template<class V1>
+  static void accept(const Mask<ON_HOST>& mask, State<B,ON_HOST>& s,
+      const int start, const int end, const PX& pax, OX& x, V1 lp);
 };
 
 /**
@@ -31,6 +40,12 @@ public:
       const int p, const PX& pax, OX& x, T1& lp) {
     //
   }
+
+  template<class V1>
+  static void accept(const Mask<ON_HOST>& mask, State<B,ON_HOST>& s,
+      const int start, const int end, const PX& pax, OX& x, V1 lp) {
+    //
+  }
 };
 }
 
@@ -70,4 +85,40 @@ void bi::SparseStaticLogDensityVisitorHost<B,S,PX,OX>::accept(
       pax, x, lp);
 }
 
+template<class B, class S, class PX, class OX>
+template<class V1>
+void bi::SparseStaticLogDensityVisitorHost<B,S,PX,OX>::accept(
+    const Mask<ON_HOST>& mask, State<B,ON_HOST>& s, const int start,
+    const int end, const PX& pax, OX& x, V1 lp) {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+  typedef typename front::target_type target_type;
+  typedef typename front::coord_type coord_type;
+
+  const int id = var_id<target_type>::value;
+  int ix = 0, p;
+  coord_type cox;
+
+  if (mask.isDense(id)) {
+    while (ix < action_size<front>::value) {
+      for (p = start; p < end; ++p) {
+        front::logDensities(s, p, ix, cox, pax, x, lp(p));
+      }
+      ++cox;
+      ++ix;
+    }
+  } else if (mask.isSparse(id)) {
+    while (ix < mask.getSize(id)) {
+      cox.setIndex(mask.getIndex(id, ix));
+      for (p = start; p < end; ++p) {
+        front::logDensities(s, p, ix, cox, pax, x, lp(p));
+      }
+      ++ix;
+    }
+  }
+
+  SparseStaticLogDensityVisitorHost<B,pop_front,PX,OX>::accept(mask, s,
+      start, end, pax, x, lp);
+}
+
 #endif
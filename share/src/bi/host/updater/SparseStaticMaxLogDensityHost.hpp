@@ -60,7 +60,7 @@ void bi::SparseStaticMaxLogDensityHost<B,S>::maxLogDensities(
     OX x;
     int p;
 
-#pragma omp for
+#pragma omp for schedule(static)
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(s, mask, p, pax, x, lp(p));
     }
@@ -60,7 +60,7 @@ void bi::SparseStaticSamplerHost<B,S>::samples(Random& rng,
     R1& rng1 = rng.getHostRng();
     int p;
 
-#pragma omp for
+#pragma omp for schedule(static)
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(rng, s, mask, p, pax, x);
     }
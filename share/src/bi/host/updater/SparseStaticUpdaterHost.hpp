@@ -51,7 +51,7 @@ void bi::SparseStaticUpdaterHost<B,S>::update(State<B,ON_HOST>& s,
     OX x;
     int p;
 
-#pragma omp for
+#pragma omp for schedule(static)
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(s, mask, p, pax, x);
     }
@@ -57,7 +57,7 @@ void bi::StaticLogDensityHost<B,S>::logDensities(State<B,ON_HOST>& s, V1 lp) {
     OX x;
     int p;
 
-#pragma omp for
+#pragma omp for schedule(static)
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(s, p, pax, x, lp(p));
     }
@@ -58,7 +58,7 @@ void bi::StaticMaxLogDensityHost<B,S>::maxLogDensities(State<B,ON_HOST>& s,
     OX x;
     int p;
 
-#pragma omp for
+#pragma omp for schedule(static)
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(s, p, pax, x, lp(p));
     }
@@ -48,7 +48,7 @@ void bi::StaticUpdaterHost<B,S>::update(State<B,ON_HOST>& s) {
     OX x;
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(s, p, pax, x);
     }
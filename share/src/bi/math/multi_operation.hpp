@@ -576,7 +576,7 @@ void bi::multi_transpose(const int P, const M1 A, M2 B) {
     typename sim_temp_matrix<M2>::type B1(B.size1()/P, B.size2());
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (int p = 0; p < P; ++p) {
       multi_get_matrix(P, A, p, A1);
       multi_get_matrix(P, B, p, B1);
@@ -599,7 +599,7 @@ void bi::multi_chol(const int P, const M1 A, M2 U, char uplo,
     typename sim_temp_matrix<M2>::type U1(U.size1()/P, U.size2());
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (int p = 0; p < P; ++p) {
       multi_get_matrix(P, A, p, A1);
       multi_get_matrix(P, U, p, U1);
@@ -135,6 +135,24 @@ template<class V1, class M1, class V2, class M2, class M3, class V4, class M4>
 void marginalise(V1 mu1, M1 U1, const V2 mu2, const M2 U2, const M3 C,
     const V4 mu3, const M4 U3);
 
+/**
+ * Triangularise stacked square-root factors.
+ *
+ * @ingroup math_op
+ *
+ * @param[in,out] A Matrix of %size \f$M \times N\f$, \f$M \geq N\f$.
+ * Overwritten on output.
+ * @param[out] U Upper-triangular matrix of %size \f$N \times N\f$.
+ *
+ * Computes the upper-triangular matrix \f$\mathbf{U}\f$, with nonnegative
+ * diagonal, such that \f$\mathbf{U}^T\mathbf{U} = \mathbf{A}^T\mathbf{A}\f$,
+ * using a QR decomposition of \f$\mathbf{A}\f$. When \f$\mathbf{A}\f$ is
+ * formed by stacking the square-root factors of a sum of covariance
+ * matrices, this gives the Cholesky factor of the sum without forming it.
+ */
+template<class M1, class M2>
+void tria(M1 A, M2 U);
+
 /**
  * @name QRUpdate (and QRUpdate-like) adapters
  */
@@ -593,6 +611,25 @@ struct potrs_impl {
   static void func(const M1 U, M2 X, char uplo);
 };
 
+/**
+ * QR factorisation.
+ *
+ * @ingroup math_op
+ *
+ * @seealso tria
+ */
+template<class M1, class V1, class V2>
+void geqrf(M1 A, V1 tau, V2 work);
+
+/**
+ * @internal
+ */
+template<Location L, class T1>
+struct geqrf_impl {
+  template<class M1, class V1, class V2>
+  static void func(M1 A, V1 tau, V2 work);
+};
+
 /**
  * Eigenvalues and eigenvectors.
  *
@@ -864,6 +901,29 @@ void bi::marginalise(V1 mu1, M1 U1, const V2 mu2, const M2 U2, const M3 C,
   chkup(U1, K, b);
 }
 
+template<class M1, class M2>
+void bi::tria(M1 A, M2 U) {
+  static const Location L = M1::on_device ? ON_DEVICE : ON_HOST;
+  typedef typename M1::value_type T1;
+  typedef typename loc_temp_vector<L,T1>::type temp_vector_type;
+  typedef typename loc_temp_matrix<L,T1>::type temp_matrix_type;
+
+  /* pre-conditions */
+  BI_ASSERT(A.size1() >= A.size2());
+  BI_ASSERT(U.size1() == A.size2() && U.size2() == A.size2());
+
+  const int N = A.size2();
+  temp_vector_type tau(N), work(64 * N), d(N);  ///@todo Query for optimal size of work, see LAPACK docs
+  temp_matrix_type R(N, N);
+
+  geqrf(A, tau, work);
+  set_upper_triangle(R, rows(A, 0, N));
+
+  /* flip signs of rows as necessary for nonnegative diagonal */
+  op_elements(diagonal(R), d, sign_functor<T1>());
+  gdmm(1.0, d, R, 0.0, U);
+}
+
 template<class M1, class M2, class V2>
 void bi::chkup(M1 U, M2 A, V2 b) {
   int j;
@@ -1321,6 +1381,26 @@ void bi::potrs(const M1 U, M2 X, char uplo) {
   potrs_impl<L,T2>::func(U, X, uplo);
 }
 
+template<class M1, class V1, class V2>
+void bi::geqrf(M1 A, V1 tau, V2 work) {
+  static const Location L = M1::on_device ? ON_DEVICE : ON_HOST;
+  typedef typename M1::value_type T1;
+  typedef typename V1::value_type T2;
+  typedef typename V2::value_type T3;
+
+  /* pre-conditions */
+  BI_ASSERT(tau.size() >= bi::min(A.size1(), A.size2()));
+  BI_ASSERT(work.size() >= A.size2());
+  BI_ASSERT(A.inc() == 1);
+  BI_ASSERT(tau.inc() == 1);
+  BI_ASSERT(work.inc() == 1);
+  BI_ASSERT((equals<T1,T2>::value));
+  BI_ASSERT((equals<T2,T3>::value));
+  BI_ASSERT(M1::on_device == V1::on_device);
+
+  geqrf_impl<L,T1>::func(A, tau, work);
+}
+
 template<class M1, class V1, class M2, class V2, class V3, class V4, class V5>
 void bi::syevx(char jobz, char range, char uplo, M1 A,
     typename M1::value_type vl, typename M1::value_type vu, int il, int iu,
@@ -0,0 +1,156 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#include "Checkpointer.hpp"
+
+#include "assert.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * Checkpoint file header.
+ */
+struct CheckpointHeader {
+  /**
+   * Magic string.
+   */
+  char magic[8];
+
+  /**
+   * Format version.
+   */
+  int version;
+
+  /**
+   * Size of payload, in bytes.
+   */
+  long long bytes;
+};
+
+static const char CHECKPOINT_MAGIC[8] = { 'L', 'I', 'B', 'B', 'I', 'C', 'K',
+    'P' };
+static const int CHECKPOINT_VERSION = 1;
+
+bi::Checkpointer::Checkpointer(const std::string& file,
+    const double interval) :
+    file(file), interval(1.0e6 * interval), last(0), writing(false), region(
+        NULL), regionBytes(0) {
+  //
+}
+
+bi::Checkpointer::~Checkpointer() {
+  wait();
+}
+
+bool bi::Checkpointer::isEnabled() const {
+  return !file.empty();
+}
+
+bool bi::Checkpointer::isDue() {
+  return isEnabled() && clock.toc() - last >= interval;
+}
+
+bool bi::Checkpointer::canRestore() const {
+  struct stat st;
+  return isEnabled() && stat(file.c_str(), &st) == 0;
+}
+
+void bi::Checkpointer::wait() {
+  if (writing) {
+    pthread_join(thread, NULL);
+    writing = false;
+  }
+}
+
+void bi::Checkpointer::begin() {
+  wait();
+  buf.resize(sizeof(CheckpointHeader));
+}
+
+void bi::Checkpointer::commit() {
+  CheckpointHeader header;
+  std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+  header.version = CHECKPOINT_VERSION;
+  header.bytes = buf.size() - sizeof(CheckpointHeader);
+  std::memcpy(&buf[0], &header, sizeof(CheckpointHeader));
+
+  last = clock.toc();
+  writing = pthread_create(&thread, NULL, write, this) == 0;
+  if (!writing) {
+    /* write in the foreground instead */
+    write(this);
+  }
+}
+
+const char* bi::Checkpointer::map(size_t& bytes) {
+  /* pre-condition */
+  BI_ASSERT(region == NULL);
+
+  struct stat st;
+  int fd = open(file.c_str(), O_RDONLY);
+  BI_ERROR_MSG(fd >= 0, "Could not open checkpoint file " << file);
+  BI_ERROR_MSG(fstat(fd, &st) == 0, "Could not stat checkpoint file " << file);
+  regionBytes = st.st_size;
+  BI_ERROR_MSG(regionBytes >= sizeof(CheckpointHeader),
+      "Checkpoint file " << file << " is truncated");
+  region = mmap(NULL, regionBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  BI_ERROR_MSG(region != MAP_FAILED, "Could not map checkpoint file " << file);
+
+  const char* ptr = static_cast<const char*>(region);
+  CheckpointHeader header;
+  std::memcpy(&header, ptr, sizeof(CheckpointHeader));
+  BI_ERROR_MSG(std::memcmp(header.magic, CHECKPOINT_MAGIC,
+      sizeof(header.magic)) == 0, "File " << file << " is not a checkpoint");
+  BI_ERROR_MSG(header.version == CHECKPOINT_VERSION,
+      "Checkpoint file " << file << " has version " << header.version << ", should have version " << CHECKPOINT_VERSION);
+  BI_ERROR_MSG(header.bytes + sizeof(CheckpointHeader) == regionBytes,
+      "Checkpoint file " << file << " is truncated");
+
+  bytes = header.bytes;
+  return ptr + sizeof(CheckpointHeader);
+}
+
+void bi::Checkpointer::unmap() {
+  if (region != NULL) {
+    munmap(region, regionBytes);
+    region = NULL;
+    regionBytes = 0;
+  }
+}
+
+void* bi::Checkpointer::write(void* ptr) {
+  Checkpointer* self = static_cast<Checkpointer*>(ptr);
+  const std::string tmp = self->file + ".tmp";
+  const char* buf = &self->buf[0];
+  size_t bytes = self->buf.size();
+  ssize_t n;
+  bool ok;
+
+  int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  ok = fd >= 0;
+  while (ok && bytes > 0) {
+    n = ::write(fd, buf, bytes);
+    ok = n > 0;
+    if (ok) {
+      buf += n;
+      bytes -= n;
+    }
+  }
+  if (fd >= 0) {
+    ok = fsync(fd) == 0 && ok;
+    ok = close(fd) == 0 && ok;
+  }
+  ok = ok && rename(tmp.c_str(), self->file.c_str()) == 0;
+  BI_WARN_MSG(ok, "Could not write checkpoint file " << self->file);
+
+  return NULL;
+}
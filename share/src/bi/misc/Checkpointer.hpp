@@ -0,0 +1,198 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_MISC_CHECKPOINTER_HPP
+#define BI_MISC_CHECKPOINTER_HPP
+
+#include "FlatArchive.hpp"
+#include "TicToc.hpp"
+
+#include <vector>
+#include <string>
+#include <pthread.h>
+
+namespace bi {
+/**
+ * Periodic checkpointing of a run, for restart.
+ *
+ * @ingroup misc
+ *
+ * A checkpoint is serialized with FlatOutputArchive into a buffer in memory,
+ * which is then written to file by a background thread, so that the run may
+ * continue while it is written. The file is written under a temporary name
+ * and renamed once complete, so that a run interrupted while writing leaves
+ * the previous checkpoint intact. On restart, the file is memory-mapped and
+ * restored with FlatInputArchive.
+ *
+ * The format is a flat binary image of the objects, preceded by a short
+ * header, and is intended only for restart on the same platform, by the
+ * same program, with the same number of threads.
+ */
+class Checkpointer {
+public:
+  /**
+   * Constructor.
+   *
+   * @param file Checkpoint file name. Empty to disable checkpointing.
+   * @param interval Minimum real time between checkpoints, in seconds.
+   */
+  Checkpointer(const std::string& file = "", const double interval = 0.0);
+
+  /**
+   * Destructor. Waits for any outstanding write to complete.
+   */
+  ~Checkpointer();
+
+  /**
+   * Is checkpointing enabled?
+   */
+  bool isEnabled() const;
+
+  /**
+   * Is a checkpoint due?
+   */
+  bool isDue();
+
+  /**
+   * Is there a checkpoint from which to restore?
+   */
+  bool canRestore() const;
+
+  /**
+   * Write checkpoint.
+   *
+   * @tparam T1 Object type.
+   * @tparam T2 Object type.
+   * @tparam T3 Object type.
+   * @tparam T4 Object type.
+   *
+   * @param o1 Object.
+   * @param o2 Object.
+   * @param o3 Object.
+   * @param o4 Object.
+   *
+   * The objects are serialized before return, the write to file continues
+   * in the background.
+   */
+  template<class T1, class T2, class T3, class T4>
+  void save(const T1& o1, const T2& o2, const T3& o3, const T4& o4);
+
+  /**
+   * Restore checkpoint.
+   *
+   * @tparam T1 Object type.
+   * @tparam T2 Object type.
+   * @tparam T3 Object type.
+   * @tparam T4 Object type.
+   *
+   * @param[out] o1 Object.
+   * @param[out] o2 Object.
+   * @param[out] o3 Object.
+   * @param[out] o4 Object.
+   */
+  template<class T1, class T2, class T3, class T4>
+  void load(T1& o1, T2& o2, T3& o3, T4& o4);
+
+  /**
+   * Wait for any outstanding write to complete.
+   */
+  void wait();
+
+private:
+  /**
+   * Prepare buffer for a new checkpoint.
+   */
+  void begin();
+
+  /**
+   * Complete buffer and start writing it to file.
+   */
+  void commit();
+
+  /**
+   * Map checkpoint file into memory.
+   *
+   * @param[out] bytes Size of the payload.
+   *
+   * @return Start of the payload.
+   */
+  const char* map(size_t& bytes);
+
+  /**
+   * Unmap checkpoint file.
+   */
+  void unmap();
+
+  /**
+   * Write buffer to file. Entry point of background thread.
+   */
+  static void* write(void* ptr);
+
+  /**
+   * File name.
+   */
+  std::string file;
+
+  /**
+   * Minimum real time between checkpoints, in microseconds.
+   */
+  long interval;
+
+  /**
+   * Clock.
+   */
+  TicToc clock;
+
+  /**
+   * Time of last checkpoint.
+   */
+  long last;
+
+  /**
+   * Buffer.
+   */
+  std::vector<char> buf;
+
+  /**
+   * Background thread.
+   */
+  pthread_t thread;
+
+  /**
+   * Is a write outstanding?
+   */
+  bool writing;
+
+  /**
+   * Mapped region.
+   */
+  void* region;
+
+  /**
+   * Size of mapped region.
+   */
+  size_t regionBytes;
+};
+}
+
+template<class T1, class T2, class T3, class T4>
+void bi::Checkpointer::save(const T1& o1, const T2& o2, const T3& o3,
+    const T4& o4) {
+  begin();
+  FlatOutputArchive ar(buf);
+  ar << o1 << o2 << o3 << o4;
+  commit();
+}
+
+template<class T1, class T2, class T3, class T4>
+void bi::Checkpointer::load(T1& o1, T2& o2, T3& o3, T4& o4) {
+  size_t bytes;
+  const char* ptr = map(bytes);
+  FlatInputArchive ar(ptr, ptr + bytes);
+  ar >> o1 >> o2 >> o3 >> o4;
+  unmap();
+}
+
+#endif
@@ -0,0 +1,318 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_MISC_FLATARCHIVE_HPP
+#define BI_MISC_FLATARCHIVE_HPP
+
+#include "assert.hpp"
+
+#include "boost/serialization/serialization.hpp"
+#include "boost/serialization/array.hpp"
+#include "boost/type_traits/is_arithmetic.hpp"
+#include "boost/type_traits/is_enum.hpp"
+#include "boost/mpl/bool.hpp"
+#include "boost/mpl/or.hpp"
+
+#include <vector>
+#include <string>
+#include <cstring>
+
+namespace bi {
+/**
+ * Flat binary output archive.
+ *
+ * @ingroup misc
+ *
+ * A minimal archive for objects supporting Boost.Serialization, writing
+ * the raw bytes of each arithmetic value, and of each array of arithmetic
+ * values in one piece, to a buffer in memory. There is no class
+ * information, object tracking or pointer support, so that the archive
+ * requires no library, and the buffer can be restored directly from a
+ * memory-mapped file with FlatInputArchive. It is intended only for
+ * restoration on the same platform, by the same program.
+ */
+class FlatOutputArchive {
+public:
+  typedef boost::mpl::bool_<true> is_saving;
+  typedef boost::mpl::bool_<false> is_loading;
+
+  /**
+   * Use array optimisation for arithmetic types.
+   */
+  struct use_array_optimization {
+    template<class T>
+    struct apply: public boost::mpl::or_<boost::is_arithmetic<T>,
+        boost::is_enum<T> > {
+      //
+    };
+  };
+
+  /**
+   * Constructor.
+   *
+   * @param buf Buffer to which to append.
+   */
+  FlatOutputArchive(std::vector<char>& buf);
+
+  /**
+   * Save object.
+   */
+  template<class T>
+  FlatOutputArchive& operator&(const T& o);
+
+  /**
+   * Save object.
+   */
+  template<class T>
+  FlatOutputArchive& operator<<(const T& o);
+
+  /**
+   * Save array of arithmetic values.
+   */
+  template<class A>
+  void save_array(const A& a, const unsigned version);
+
+  /**
+   * Save raw bytes.
+   */
+  void save_binary(const void* ptr, const size_t bytes);
+
+private:
+  template<class T>
+  void save(const T& o, const boost::mpl::true_&);
+
+  template<class T>
+  void save(const T& o, const boost::mpl::false_&);
+
+  template<class T>
+  void save(const std::vector<T>& o, const boost::mpl::false_&);
+
+  void save(const std::string& o, const boost::mpl::false_&);
+
+  /**
+   * Buffer.
+   */
+  std::vector<char>& buf;
+};
+
+/**
+ * Flat binary input archive.
+ *
+ * @ingroup misc
+ *
+ * Restores objects saved with FlatOutputArchive from a region of memory.
+ * Objects must already be constructed, and are resized by their own
+ * serialization functions as required.
+ */
+class FlatInputArchive {
+public:
+  typedef boost::mpl::bool_<false> is_saving;
+  typedef boost::mpl::bool_<true> is_loading;
+
+  /**
+   * @copydoc FlatOutputArchive::use_array_optimization
+   */
+  typedef FlatOutputArchive::use_array_optimization use_array_optimization;
+
+  /**
+   * Constructor.
+   *
+   * @param begin Start of region.
+   * @param end End of region.
+   */
+  FlatInputArchive(const char* begin, const char* end);
+
+  /**
+   * Load object.
+   */
+  template<class T>
+  FlatInputArchive& operator&(T& o);
+
+  /**
+   * Load object.
+   */
+  template<class T>
+  FlatInputArchive& operator>>(T& o);
+
+  /**
+   * Load object from wrapper, such as that of boost::serialization::make_array().
+   */
+  template<class T>
+  FlatInputArchive& operator&(const T& o);
+
+  /**
+   * Load object from wrapper, such as that of boost::serialization::make_array().
+   */
+  template<class T>
+  FlatInputArchive& operator>>(const T& o);
+
+  /**
+   * Load array of arithmetic values.
+   */
+  template<class A>
+  void load_array(A& a, const unsigned version);
+
+  /**
+   * Load raw bytes.
+   */
+  void load_binary(void* ptr, const size_t bytes);
+
+private:
+  template<class T>
+  void load(T& o, const boost::mpl::true_&);
+
+  template<class T>
+  void load(T& o, const boost::mpl::false_&);
+
+  template<class T>
+  void load(std::vector<T>& o, const boost::mpl::false_&);
+
+  void load(std::string& o, const boost::mpl::false_&);
+
+  /**
+   * Current position.
+   */
+  const char* ptr;
+
+  /**
+   * End of region.
+   */
+  const char* end;
+};
+}
+
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(bi::FlatOutputArchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(bi::FlatInputArchive)
+
+inline bi::FlatOutputArchive::FlatOutputArchive(std::vector<char>& buf) :
+    buf(buf) {
+  //
+}
+
+template<class T>
+inline bi::FlatOutputArchive& bi::FlatOutputArchive::operator&(const T& o) {
+  return *this << o;
+}
+
+template<class T>
+inline bi::FlatOutputArchive& bi::FlatOutputArchive::operator<<(
+    const T& o) {
+  save(o, typename boost::mpl::or_<boost::is_arithmetic<T>,
+      boost::is_enum<T> >::type());
+  return *this;
+}
+
+template<class A>
+inline void bi::FlatOutputArchive::save_array(const A& a,
+    const unsigned version) {
+  save_binary(a.address(), a.count() * sizeof(*a.address()));
+}
+
+inline void bi::FlatOutputArchive::save_binary(const void* ptr,
+    const size_t bytes) {
+  const char* p = static_cast<const char*>(ptr);
+  buf.insert(buf.end(), p, p + bytes);
+}
+
+template<class T>
+inline void bi::FlatOutputArchive::save(const T& o,
+    const boost::mpl::true_&) {
+  save_binary(&o, sizeof(T));
+}
+
+template<class T>
+inline void bi::FlatOutputArchive::save(const T& o,
+    const boost::mpl::false_&) {
+  boost::serialization::serialize_adl(*this, const_cast<T&>(o), 0u);
+}
+
+template<class T>
+inline void bi::FlatOutputArchive::save(const std::vector<T>& o,
+    const boost::mpl::false_&) {
+  int size = o.size();
+  *this << size;
+  for (int i = 0; i < size; ++i) {
+    *this << o[i];
+  }
+}
+
+inline void bi::FlatOutputArchive::save(const std::string& o,
+    const boost::mpl::false_&) {
+  int size = o.size();
+  *this << size;
+  save_binary(o.data(), size);
+}
+
+inline bi::FlatInputArchive::FlatInputArchive(const char* begin,
+    const char* end) :
+    ptr(begin), end(end) {
+  //
+}
+
+template<class T>
+inline bi::FlatInputArchive& bi::FlatInputArchive::operator&(T& o) {
+  return *this >> o;
+}
+
+template<class T>
+inline bi::FlatInputArchive& bi::FlatInputArchive::operator>>(T& o) {
+  load(o, typename boost::mpl::or_<boost::is_arithmetic<T>,
+      boost::is_enum<T> >::type());
+  return *this;
+}
+
+template<class T>
+inline bi::FlatInputArchive& bi::FlatInputArchive::operator&(const T& o) {
+  return *this >> o;
+}
+
+template<class T>
+inline bi::FlatInputArchive& bi::FlatInputArchive::operator>>(const T& o) {
+  boost::serialization::serialize_adl(*this, const_cast<T&>(o), 0u);
+  return *this;
+}
+
+template<class A>
+inline void bi::FlatInputArchive::load_array(A& a, const unsigned version) {
+  load_binary(a.address(), a.count() * sizeof(*a.address()));
+}
+
+inline void bi::FlatInputArchive::load_binary(void* ptr, const size_t bytes) {
+  BI_ERROR_MSG(this->ptr + bytes <= end, "Unexpected end of archive");
+  std::memcpy(ptr, this->ptr, bytes);
+  this->ptr += bytes;
+}
+
+template<class T>
+inline void bi::FlatInputArchive::load(T& o, const boost::mpl::true_&) {
+  load_binary(&o, sizeof(T));
+}
+
+template<class T>
+inline void bi::FlatInputArchive::load(T& o, const boost::mpl::false_&) {
+  boost::serialization::serialize_adl(*this, o, 0u);
+}
+
+template<class T>
+inline void bi::FlatInputArchive::load(std::vector<T>& o,
+    const boost::mpl::false_&) {
+  int size;
+  *this >> size;
+  o.resize(size);
+  for (int i = 0; i < size; ++i) {
+    *this >> o[i];
+  }
+}
+
+inline void bi::FlatInputArchive::load(std::string& o,
+    const boost::mpl::false_&) {
+  int size;
+  *this >> size;
+  BI_ERROR_MSG(ptr + size <= end, "Unexpected end of archive");
+  o.assign(ptr, size);
+  ptr += size;
+}
+
+#endif
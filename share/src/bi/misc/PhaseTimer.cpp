@@ -0,0 +1,8 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#include "PhaseTimer.hpp"
+
+bool bi::PhaseTimer::enabled = false;
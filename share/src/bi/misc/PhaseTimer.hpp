@@ -0,0 +1,276 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_MISC_PHASETIMER_HPP
+#define BI_MISC_PHASETIMER_HPP
+
+#include "TicToc.hpp"
+#include "assert.hpp"
+#include "../cuda/cuda.hpp"
+
+#include "boost/serialization/serialization.hpp"
+
+#include <iostream>
+#include <algorithm>
+
+namespace bi {
+/**
+ * Phases of a run, for instrumentation.
+ *
+ * @ingroup misc
+ */
+enum Phase {
+  /**
+   * Update of inputs and observations.
+   */
+  PHASE_INPUT,
+
+  /**
+   * Transition of state.
+   */
+  PHASE_TRANSITION,
+
+  /**
+   * Observation densities.
+   */
+  PHASE_OBSERVATION,
+
+  /**
+   * Reductions over weights.
+   */
+  PHASE_REDUCE,
+
+  /**
+   * Resampling.
+   */
+  PHASE_RESAMPLE,
+
+  /**
+   * Output and flush.
+   */
+  PHASE_OUTPUT,
+
+  /**
+   * Waiting on other processes.
+   */
+  PHASE_WAIT,
+
+  /**
+   * Number of phases.
+   */
+  NUM_PHASES
+};
+
+/**
+ * Accumulates real time spent in each phase of a run.
+ *
+ * @ingroup misc
+ *
+ * A single clock runs continuously. A call to toc() attributes the time
+ * since the last call to tic() or toc() to the given phase, so that a
+ * sequence of phases is timed with one call to tic() followed by one call
+ * to toc() per phase. Device execution is synchronized before reading the
+ * clock, so that asynchronous kernels are attributed to the phase that
+ * launched them.
+ *
+ * Timing is disabled by default, in which case tic() and toc() neither
+ * read the clock nor synchronize, so that device work is not serialized
+ * for the sake of instrumentation that is not reported. Enable it with
+ * setEnabled().
+ */
+class PhaseTimer {
+public:
+  /**
+   * Constructor.
+   */
+  PhaseTimer();
+
+  /**
+   * Start or restart the clock, without attributing time to any phase.
+   */
+  void tic();
+
+  /**
+   * Attribute time since the last call to tic() or toc() to a phase, and
+   * restart the clock.
+   *
+   * @param phase Phase.
+   */
+  void toc(const Phase phase);
+
+  /**
+   * Total time spent in a phase.
+   *
+   * @param phase Phase.
+   *
+   * @return Number of microseconds.
+   */
+  long get(const Phase phase) const;
+
+  /**
+   * Total time spent in all phases.
+   *
+   * @return Number of microseconds.
+   */
+  long total() const;
+
+  /**
+   * Add the times of another timer to this one.
+   */
+  void add(const PhaseTimer& o);
+
+  /**
+   * Reset all phases to zero.
+   */
+  void reset();
+
+  /**
+   * Swap with another timer.
+   */
+  void swap(PhaseTimer& o);
+
+  /**
+   * Write phase times as space-separated @c name=microseconds pairs.
+   *
+   * @param out Output stream.
+   */
+  void print(std::ostream& out) const;
+
+  /**
+   * Is timing enabled?
+   */
+  static bool isEnabled();
+
+  /**
+   * Enable or disable timing, for all timers.
+   *
+   * @param enabled True to enable timing.
+   */
+  static void setEnabled(const bool enabled);
+
+  /**
+   * Name of a phase.
+   *
+   * @param phase Phase.
+   *
+   * @return Name.
+   */
+  static const char* getName(const Phase phase);
+
+private:
+  /**
+   * Clock.
+   */
+  TicToc clock;
+
+  /**
+   * Time spent in each phase, in microseconds.
+   */
+  long usecs[NUM_PHASES];
+
+  /**
+   * Is timing enabled?
+   */
+  static bool enabled;
+
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void serialize(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  friend class boost::serialization::access;
+};
+}
+
+inline bi::PhaseTimer::PhaseTimer() {
+  reset();
+}
+
+inline void bi::PhaseTimer::tic() {
+  if (enabled) {
+    synchronize();
+    clock.tic();
+  }
+}
+
+inline void bi::PhaseTimer::toc(const Phase phase) {
+  /* pre-condition */
+  BI_ASSERT(phase >= 0 && phase < NUM_PHASES);
+
+  if (enabled) {
+    synchronize();
+    usecs[phase] += clock.toc();
+    clock.tic();
+  }
+}
+
+inline long bi::PhaseTimer::get(const Phase phase) const {
+  /* pre-condition */
+  BI_ASSERT(phase >= 0 && phase < NUM_PHASES);
+
+  return usecs[phase];
+}
+
+inline long bi::PhaseTimer::total() const {
+  long t = 0;
+  for (int i = 0; i < NUM_PHASES; ++i) {
+    t += usecs[i];
+  }
+  return t;
+}
+
+inline void bi::PhaseTimer::add(const PhaseTimer& o) {
+  for (int i = 0; i < NUM_PHASES; ++i) {
+    usecs[i] += o.usecs[i];
+  }
+}
+
+inline void bi::PhaseTimer::reset() {
+  std::fill(usecs, usecs + NUM_PHASES, 0l);
+}
+
+inline void bi::PhaseTimer::swap(PhaseTimer& o) {
+  std::swap_ranges(usecs, usecs + NUM_PHASES, o.usecs);
+}
+
+inline void bi::PhaseTimer::print(std::ostream& out) const {
+  for (int i = 0; i < NUM_PHASES; ++i) {
+    if (i > 0) {
+      out << ' ';
+    }
+    out << getName(static_cast<Phase>(i)) << '=' << usecs[i];
+  }
+}
+
+inline bool bi::PhaseTimer::isEnabled() {
+  return enabled;
+}
+
+inline void bi::PhaseTimer::setEnabled(const bool enabled) {
+  PhaseTimer::enabled = enabled;
+}
+
+inline const char* bi::PhaseTimer::getName(const Phase phase) {
+  static const char* names[NUM_PHASES] = { "input", "transition",
+      "observation", "reduce", "resample", "output", "wait" };
+
+  /* pre-condition */
+  BI_ASSERT(phase >= 0 && phase < NUM_PHASES);
+
+  return names[phase];
+}
+
+template<class Archive>
+void bi::PhaseTimer::serialize(Archive& ar, const unsigned version) {
+  for (int i = 0; i < NUM_PHASES; ++i) {
+    ar & usecs[i];
+  }
+}
+
+#endif
@@ -6,10 +6,18 @@
 #include "omp.hpp"
 
 #include "../cuda/cuda.hpp"
+#include "assert.hpp"
 
 BI_THREAD int bi_omp_tid;
 int bi_omp_max_threads;
 
+#if defined(ENABLE_OPENMP) and defined(HAVE_OMP_H)
+/**
+ * Number of threads given to bi_omp_init().
+ */
+static int bi_omp_init_threads = 1;
+#endif
+
 #ifdef ENABLE_CUDA
 BI_THREAD cublasHandle_t bi_omp_cublas_handle;
 BI_THREAD cudaStream_t bi_omp_cuda_stream;
@@ -33,6 +41,7 @@ void bi_omp_init(const int threads) {
   }
 
   bi_omp_max_threads = omp_get_max_threads(); // must be outside parallel block
+  bi_omp_init_threads = bi_omp_max_threads;
   #pragma omp parallel
   {
     bi_omp_tid = omp_get_thread_num();
@@ -51,6 +60,16 @@ void bi_omp_init(const int threads) {
 #endif
 }
 
+void bi_omp_set_threads(const int threads) {
+  #if defined(ENABLE_OPENMP) and defined(HAVE_OMP_H)
+  /* pre-condition */
+  BI_ASSERT(threads > 0 && threads <= bi_omp_init_threads);
+
+  omp_set_num_threads(threads);
+  bi_omp_max_threads = threads;
+  #endif
+}
+
 void bi_omp_term() {
   #pragma omp parallel
   {
@@ -56,6 +56,14 @@ extern BI_THREAD cudaStream_t bi_omp_cuda_stream;
  */
 void bi_omp_init(const int threads = 0);
 
+/**
+ * Change the number of threads used by subsequent parallel regions.
+ *
+ * @param threads Number of threads. Must not exceed the number of threads
+ * given by bi_omp_init(), for which thread-private resources were created.
+ */
+void bi_omp_set_threads(const int threads);
+
 /**
  * Terminate OpenMP environment.
  */
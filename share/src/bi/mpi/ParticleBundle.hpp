@@ -0,0 +1,126 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_MPI_PARTICLEBUNDLE_HPP
+#define BI_MPI_PARTICLEBUNDLE_HPP
+
+#include "boost/serialization/split_member.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * Bundle of particles for transfer to or from one other process in a single
+ * message.
+ *
+ * @ingroup server
+ *
+ * @tparam S1 State type.
+ * @tparam IO1 Output type.
+ *
+ * The bundle holds pointers to particles held elsewhere, so that particles
+ * are serialized directly from, and deserialized directly into, their
+ * positions in the state. Particles are transferred in the order in which
+ * they are added, so sender and receiver must add them in the same order.
+ * Matrices and vectors in host memory are serialized one contiguous region
+ * at a time, so that the message is a short header of sizes and scalars for
+ * each particle, followed by its buffers.
+ */
+template<class S1, class IO1>
+class ParticleBundle {
+public:
+  /**
+   * Add particle.
+   *
+   * @param s State of particle.
+   * @param out Output of particle.
+   */
+  void push_back(S1* s, IO1* out);
+
+  /**
+   * Number of particles in bundle.
+   */
+  int size() const;
+
+  /**
+   * Is the bundle empty?
+   */
+  bool empty() const;
+
+private:
+  /**
+   * States.
+   */
+  std::vector<S1*> s1s;
+
+  /**
+   * Outputs.
+   */
+  std::vector<IO1*> out1s;
+
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization. The bundle must already hold the same
+   * number of particles as were saved.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
+};
+}
+
+#include "../misc/assert.hpp"
+
+template<class S1, class IO1>
+inline void bi::ParticleBundle<S1,IO1>::push_back(S1* s, IO1* out) {
+  s1s.push_back(s);
+  out1s.push_back(out);
+}
+
+template<class S1, class IO1>
+inline int bi::ParticleBundle<S1,IO1>::size() const {
+  return s1s.size();
+}
+
+template<class S1, class IO1>
+inline bool bi::ParticleBundle<S1,IO1>::empty() const {
+  return s1s.empty();
+}
+
+template<class S1, class IO1>
+template<class Archive>
+void bi::ParticleBundle<S1,IO1>::save(Archive& ar,
+    const unsigned version) const {
+  int P = size();
+  ar & P;
+  for (int p = 0; p < P; ++p) {
+    ar & *s1s[p];
+    ar & *out1s[p];
+  }
+}
+
+template<class S1, class IO1>
+template<class Archive>
+void bi::ParticleBundle<S1,IO1>::load(Archive& ar, const unsigned version) {
+  int P;
+  ar & P;
+  BI_ASSERT(P == size());
+  for (int p = 0; p < P; ++p) {
+    ar & *s1s[p];
+    ar & *out1s[p];
+  }
+}
+
+#endif
@@ -63,7 +63,21 @@ enum MPITag {
   MPI_TAG_ADAPTER_SAMPLES,
 
   /*
-   * Base tag index when redistributing particles.
+   * Tempering tags.
+   */
+  MPI_TAG_TEMPERING_LOGLIKELIHOOD,
+  MPI_TAG_TEMPERING_ACCEPT,
+  MPI_TAG_TEMPERING_STATE,
+
+  /*
+   * Island resampling tags.
+   */
+  MPI_TAG_ISLAND_OFFSET,
+  MPI_TAG_ISLAND_COUNT,
+  MPI_TAG_ISLAND_STATE,
+
+  /*
+   * Particle transfers between processes.
    */
   MPI_TAG_PARTICLE
 };
@@ -9,6 +9,8 @@
 #include "../../resampler/Resampler.hpp"
 
 #include <vector>
+#include <list>
+#include <map>
 
 namespace bi {
 /**
@@ -17,6 +19,20 @@ namespace bi {
  * @ingroup method_resampler
  *
  * @tparam R Resampler type.
+ *
+ * Two strategies are available. By default, log-weights are gathered to the
+ * root process, which computes offspring for all particles and broadcasts
+ * them, after which particles are redistributed so that all processes have
+ * the same number, and rotated so that all processes have a random sample.
+ *
+ * In island mode, processes exchange only the totals of their weights. The
+ * number of offspring on each process is allocated systematically from an
+ * exclusive scan of these totals, each process then resamples locally with
+ * @p R, and surplus offspring are shifted to neighbouring processes
+ * according to their position in the global ordering given by a scan of the
+ * offspring counts. Communication is then O(log N) in the number of
+ * processes N, rather than O(NP) to and from the root, and the root no
+ * longer performs O(NP) work.
  */
 template<class R>
 class DistributedResampler: public Resampler<R> {
@@ -28,8 +44,20 @@ public:
    * to trigger resampling.
    * @param Use anytime mode? Triggers correction of marginal likelihood
    * estimates for the elimination of active particles.
+   * @param island Use island mode?
+   */
+  DistributedResampler(const double essRel = 0.5, const bool anytime = false,
+      const bool island = false);
+
+  /**
+   * Is island mode in use?
+   */
+  bool getIsland() const;
+
+  /**
+   * Set island mode.
    */
-  DistributedResampler(const double essRel = 0.5, const bool anytime = false);
+  void setIsland(const bool island);
 
   /**
    * @copydoc Resampler::reduce(const V1, double*)
@@ -44,6 +72,30 @@ public:
   bool resample(Random& rng, const ScheduleElement now, S1& s);
 
 private:
+  /**
+   * Resample with offspring computed on the root process.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param now Current step in time schedule.
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void rootResample(Random& rng, const ScheduleElement now, S1& s);
+
+  /**
+   * Resample in island mode.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param now Current step in time schedule.
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void islandResample(Random& rng, const ScheduleElement now, S1& s);
+
   /**
    * Redistribute offspring around processes so that all processes have same
    * number of particles.
@@ -69,6 +121,11 @@ private:
   template<class S1>
   void rotate(S1& s);
 
+  /**
+   * Use island mode?
+   */
+  bool island;
+
   /**
    * @name Timing
    */
@@ -87,29 +144,41 @@ private:
 }
 
 #include "../mpi.hpp"
+#include "../ParticleBundle.hpp"
 #include "../../math/temp_vector.hpp"
 #include "../../math/temp_matrix.hpp"
 #include "../../math/view.hpp"
 
 template<class R>
 bi::DistributedResampler<R>::DistributedResampler(const double essRel,
-    const bool anytime) :
-    Resampler<R>(essRel, anytime) {
+    const bool anytime, const bool island) :
+    Resampler<R>(essRel, anytime), island(island) {
   //
 }
 
+template<class R>
+bool bi::DistributedResampler<R>::getIsland() const {
+  return island;
+}
+
+template<class R>
+void bi::DistributedResampler<R>::setIsland(const bool island) {
+  this->island = island;
+}
+
 template<class R>
 template<class V1>
 double bi::DistributedResampler<R>::reduce(const V1 lws, double* lW) {
   typedef typename V1::value_type T1;
 
   boost::mpi::communicator world;
-  const int size = world.size();
   T1 mx, sum1, sum2;
-  int P;
+  int P, E;
 
   P = lws.size();
   P = boost::mpi::all_reduce(world, P, std::plus<int>());
+  E = this->anytime ? this->neliminated : 0;
+  E = boost::mpi::all_reduce(world, E, std::plus<int>());
   mx = max_reduce(lws);
   mx = boost::mpi::all_reduce(world, mx, boost::mpi::maximum<T1>());
 
@@ -122,12 +191,7 @@ double bi::DistributedResampler<R>::reduce(const V1 lws, double* lW) {
   sum2 = boost::mpi::all_reduce(world, sum2, std::plus<T1>());
 
   if (lW != NULL) {
-    *lW = mx + bi::log(sum1);
-    if (this->anytime) {
-      *lW -= bi::log(double(size * (P - 1)));
-    } else {
-      *lW -= bi::log(double(size * P));
-    }
+    *lW = mx + bi::log(sum1) - bi::log(double(P - E));
   }
   return (sum1 * sum1) / sum2;
 }
@@ -137,59 +201,251 @@ template<class S1>
 bool bi::DistributedResampler<R>::resample(Random& rng,
     const ScheduleElement now, S1& s) {
   boost::mpi::communicator world;
-  const int rank = world.rank();
   const int size = world.size();
   const int P = s.size();
 
   bool r = (now.isObserved() || now.hasBridge())
       && s.ess < this->essRel * size * P;
   if (r) {
+    if (island) {
+      islandResample(rng, now, s);
+    } else {
+      rootResample(rng, now, s);
+    }
+  } else if (now.hasOutput()) {
+    seq_elements(s.ancestors(), 0);
+  }
+  return r;
+}
+
+template<class R>
+template<class S1>
+void bi::DistributedResampler<R>::rootResample(Random& rng,
+    const ScheduleElement now, S1& s) {
+  boost::mpi::communicator world;
+  const int rank = world.rank();
+  const int size = world.size();
+  const int P = s.size();
+
 #if ENABLE_DIAGNOSTICS == 2
+  synchronize();
+  TicToc clock;
+#endif
+
+  typename temp_host_matrix<real>::type Lws(P, size);
+  typename temp_host_matrix<int>::type O(P, size);
+  typename temp_host_vector<int>::type as1(P);
+
+  /* gather weights to root */
+  if (S1::on_device) {
+    /* gather takes raw pointer, so need to copy to host */
+    typename temp_host_vector<real>::type lws1(P);
+    lws1 = s.logWeights();
     synchronize();
-    TicToc clock;
+    boost::mpi::gather(world, lws1.buf(), P, vec(Lws).buf(), 0);
+  } else {
+    /* already on host */
+    boost::mpi::gather(world, s.logWeights().buf(), P, vec(Lws).buf(), 0);
+  }
+
+  /* compute offspring on root and broadcast */
+  if (rank == 0) {
+    typename precompute_type<R,S1::temp_int_vector_type::location>::type pre;
+
+    R::precompute(vec(Lws), pre);
+    R::offspring(rng, vec(Lws), P * size, vec(O), pre);
+  }
+  boost::mpi::broadcast(world, O.buf(), P * size, 0);
+
+#if ENABLE_DIAGNOSTICS == 2
+  long usecs = clock.toc();
+  const int timesteps = s.front()->getOutput().size() - 1;
+  reportResample(timesteps, rank, usecs);
 #endif
+  redistribute(O, s);
+  offspringToAncestors(column(O, rank), as1);
+  permute(as1);
+  s.gather(now, as1);
+  set_elements(s.logWeights(), s.logLikelihood);
+  this->shuffle(rng, s);
+  rotate(s);
+}
 
-    typename temp_host_matrix<real>::type Lws(P, size);
-    typename temp_host_matrix<int>::type O(P, size);
-    typename temp_host_vector<int>::type as1(P);
-
-    /* gather weights to root */
-    if (S1::on_device) {
-      /* gather takes raw pointer, so need to copy to host */
-      typename temp_host_vector<real>::type lws1(P);
-      lws1 = s.logWeights();
-      synchronize();
-      boost::mpi::gather(world, lws1.buf(), P, vec(Lws).buf(), 0);
-    } else {
-      /* already on host */
-      boost::mpi::gather(world, s.logWeights().buf(), P, vec(Lws).buf(), 0);
+template<class R>
+template<class S1>
+void bi::DistributedResampler<R>::islandResample(Random& rng,
+    const ScheduleElement now, S1& s) {
+  typedef typename temp_host_vector<real>::type real_vector_type;
+  typedef typename temp_host_vector<int>::type int_vector_type;
+  typedef ParticleBundle<typename S1::filter_state_type,
+      typename S1::filter_output_type> bundle_type;
+
+#if ENABLE_DIAGNOSTICS == 2
+  synchronize();
+  TicToc clock;
+#endif
+
+  boost::mpi::communicator world;
+  const int rank = world.rank();
+  const int size = world.size();
+  const int P = s.size();
+
+  real_vector_type lws(P);
+  int_vector_type os(P), os1(P), as1(P);
+  std::vector<int> sends, dests, ndests, srcs, nsrcs, slots;
+  std::list<boost::mpi::request> sendReqs, recvReqs;
+  real mx, W, C, u;
+  int first, last, n, nbelow, nabove, nkeep, nsend, nrecv, nsafe, i, j, p, q;
+
+  lws = s.logWeights();
+  synchronize(S1::on_device);
+
+  /* totals of weights, the only exchange of weight information */
+  mx = max_reduce(lws);
+  mx = boost::mpi::all_reduce(world, mx, boost::mpi::maximum<real>());
+  W = op_reduce(lws, nan_minus_and_exp_functor<real>(mx), 0.0,
+      thrust::plus<real>());
+  C = boost::mpi::scan(world, W, std::plus<real>());
+  W = boost::mpi::all_reduce(world, W, std::plus<real>());
+
+  /* systematic allocation of offspring to processes, with a common offset;
+   * the maximum scan keeps the cumulative counts monotonic against round
+   * off in the scan of weights */
+  if (rank == 0) {
+    u = rng.uniform(0.0, 1.0);
+  }
+  boost::mpi::broadcast(world, u, 0);
+  if (rank == size - 1) {
+    last = P * size;
+  } else {
+    last = bi::min(static_cast<int>(bi::floor(P * size * C / W + u)),
+        P * size);
+  }
+  last = boost::mpi::scan(world, last, boost::mpi::maximum<int>());
+
+  /* first global index of this process' offspring, from the previous
+   * process */
+  first = 0;
+  if (rank < size - 1) {
+    sendReqs.push_back(world.isend(rank + 1, MPI_TAG_ISLAND_OFFSET, last));
+  }
+  if (rank > 0) {
+    world.recv(rank - 1, MPI_TAG_ISLAND_OFFSET, first);
+  }
+  boost::mpi::wait_all(sendReqs.begin(), sendReqs.end());
+  sendReqs.clear();
+  n = last - first;
+
+  /* resample locally */
+  if (n > 0) {
+    typename precompute_type<R,S1::temp_int_vector_type::location>::type pre;
+
+    R::precompute(lws, pre);
+    R::offspring(rng, lws, n, os, pre);
+  } else {
+    os.clear();
+  }
+  os1 = os;
+
+  /* offspring with global index below or above this process' range of
+   * [rank*P, (rank + 1)*P) are sent on; extra copies of particles are
+   * sent first, so that the slots of as few particles as possible are
+   * vacated */
+  nbelow = bi::max(0, bi::min(rank * P - first, n));
+  nabove = bi::max(0, bi::min(last - (rank + 1) * P, n));
+  nkeep = n - nbelow - nabove;
+  nsend = nbelow + nabove;
+  nrecv = P - nkeep;
+
+  for (p = 0; p < P && (int)sends.size() < nsend; ++p) {
+    while (os1(p) > 1 && (int)sends.size() < nsend) {
+      sends.push_back(p);
+      --os1(p);
+    }
+  }
+  for (p = 0; p < P && (int)sends.size() < nsend; ++p) {
+    if (os1(p) == 1) {
+      sends.push_back(p);
+      --os1(p);
+    }
+  }
+  BI_ASSERT((int)sends.size() == nsend);
+
+  /* destinations, in increasing order */
+  for (j = 0; j < nsend; ++j) {
+    q = (j < nbelow) ? (first + j) / P : (first + nkeep + j) / P;
+    if (dests.empty() || dests.back() != q) {
+      dests.push_back(q);
+      ndests.push_back(0);
+    }
+    ++ndests.back();
+  }
+
+  /* send, one message per destination */
+  for (i = 0, j = 0; i < (int)dests.size(); ++i) {
+    bundle_type bundle;
+    for (q = 0; q < ndests[i]; ++q, ++j) {
+      bundle.push_back(s.s1s[sends[j]], s.out1s[sends[j]]);
     }
+    sendReqs.push_back(world.isend(dests[i], MPI_TAG_ISLAND_COUNT,
+        ndests[i]));
+    sendReqs.push_back(world.isend(dests[i], MPI_TAG_ISLAND_STATE, bundle));
+  }
+
+  /* sources are not known in advance, only the total number to receive */
+  for (i = 0; i < nrecv; i += nsrcs.back()) {
+    boost::mpi::status status = world.probe(boost::mpi::any_source,
+        MPI_TAG_ISLAND_COUNT);
+    srcs.push_back(status.source());
+    nsrcs.push_back(0);
+    world.recv(srcs.back(), MPI_TAG_ISLAND_COUNT, nsrcs.back());
+  }
+  BI_ASSERT(i == nrecv);
 
-    /* compute offspring on root and broadcast */
-    if (rank == 0) {
-      typename precompute_type<R,S1::temp_int_vector_type::location>::type pre;
+  /* receive into slots of particles without offspring, first those never
+   * used, then those vacated by sends, which must wait for the sends to
+   * complete; transfers between two neighbouring processes only go in one
+   * direction, so the wait cannot deadlock */
+  for (p = 0; p < P; ++p) {
+    if (os(p) == 0) {
+      slots.push_back(p);
+    }
+  }
+  nsafe = bi::min(static_cast<int>(slots.size()), nrecv);
+  for (p = 0; p < P && (int)slots.size() < nrecv; ++p) {
+    if (os(p) > 0 && os1(p) == 0) {
+      slots.push_back(p);
+    }
+  }
+  BI_ASSERT((int)slots.size() >= nrecv);
 
-      R::precompute(vec(Lws), pre);
-      R::offspring(rng, vec(Lws), P * size, vec(O), pre);
+  std::vector<bundle_type> bundles(srcs.size());
+  for (i = 0, j = 0; i < (int)srcs.size(); ++i) {
+    if (j + nsrcs[i] > nsafe && !sendReqs.empty()) {
+      boost::mpi::wait_all(sendReqs.begin(), sendReqs.end());
+      sendReqs.clear();
     }
-    boost::mpi::broadcast(world, O.buf(), P * size, 0);
+    for (q = 0; q < nsrcs[i]; ++q, ++j) {
+      bundles[i].push_back(s.s1s[slots[j]], s.out1s[slots[j]]);
+      os1(slots[j]) = 1;
+    }
+    recvReqs.push_back(world.irecv(srcs[i], MPI_TAG_ISLAND_STATE,
+        bundles[i]));
+  }
+  boost::mpi::wait_all(sendReqs.begin(), sendReqs.end());
+  boost::mpi::wait_all(recvReqs.begin(), recvReqs.end());
 
 #if ENABLE_DIAGNOSTICS == 2
-    long usecs = clock.toc();
-    const int timesteps = s.front()->getOutput().size() - 1;
-    reportResample(timesteps, rank, usecs);
+  long usecs = clock.toc();
+  const int timesteps = s.front()->getOutput().size() - 1;
+  reportResample(timesteps, rank, usecs);
 #endif
-    redistribute(O, s);
-    offspringToAncestors(column(O, rank), as1);
-    permute(as1);
-    s.gather(now, as1);
-    set_elements(s.logWeights(), s.logLikelihood);
-    this->shuffle(rng, s);
-    rotate(s);
-  } else if (now.hasOutput()) {
-    seq_elements(s.ancestors(), 0);
-  }
-  return r;
+
+  offspringToAncestors(os1, as1);
+  permute(as1);
+  s.gather(now, as1);
+  set_elements(s.logWeights(), s.logLikelihood);
+  this->shuffle(rng, s);
 }
 
 template<class R>
@@ -214,10 +470,15 @@ void bi::DistributedResampler<R>::redistribute(M1 O, S1& s) {
   const int size = world.size();
   const int P = O.size1();
 
-  int sendi, recvi, sendj, recvj, sendn, recvn, n, sendr, recvr, tag = 0;
+  typedef ParticleBundle<typename S1::filter_state_type,
+      typename S1::filter_output_type> bundle_type;
+
+  int sendi, recvi, sendj, recvj, sendn, recvn, n, sendr, recvr;
+  bool sending = false;
 
   int_vector_type Ps(size);  // number of particles in each process
   int_vector_type ranks(size);  // ranks sorted by number of particles
+  std::map<int,bundle_type> bundles;  // particles to transfer, by peer
   std::list < boost::mpi::request > reqs;
 
   sum_rows(O, Ps);
@@ -260,15 +521,13 @@ void bi::DistributedResampler<R>::redistribute(M1 O, S1& s) {
     BI_ASSERT(Ps(sendj) >= P);
     BI_ASSERT(Ps(recvj) <= P);
 
-    /* transfer particle */
+    /* add particle to bundle for transfer */
     if (rank == recvr) {
-      reqs.push_back(world.irecv(sendr, tag, *s.s1s[recvi]));
-      reqs.push_back(world.irecv(sendr, tag + 1, *s.out1s[recvi]));
+      bundles[sendr].push_back(s.s1s[recvi], s.out1s[recvi]);
     } else if (rank == sendr) {
-      reqs.push_back(world.isend(recvr, tag, *s.s1s[sendi]));
-      reqs.push_back(world.isend(recvr, tag + 1, *s.out1s[sendi]));
+      bundles[recvr].push_back(s.s1s[sendi], s.out1s[sendi]);
+      sending = true;
     }
-    tag += 2;
 
     if (Ps(sendj) == P) {
       --sendj;
@@ -280,7 +539,18 @@ void bi::DistributedResampler<R>::redistribute(M1 O, S1& s) {
     }
   }
 
-  /* wait for all copies to complete */
+  /* transfer, one message per peer; a process only sends or only
+   * receives */
+  typename std::map<int,bundle_type>::iterator iter;
+  for (iter = bundles.begin(); iter != bundles.end(); ++iter) {
+    if (sending) {
+      reqs.push_back(world.isend(iter->first, MPI_TAG_PARTICLE,
+          iter->second));
+    } else {
+      reqs.push_back(world.irecv(iter->first, MPI_TAG_PARTICLE,
+          iter->second));
+    }
+  }
   boost::mpi::wait_all(reqs.begin(), reqs.end());
 
 #if ENABLE_DIAGNOSTICS == 2
@@ -298,44 +568,25 @@ void bi::DistributedResampler<R>::rotate(S1& s) {
   const int size = world.size();
   const int P = s.size();
 
-  std::vector < boost::mpi::request > sends1(P), sends2(P);
-  int p, sendr, recvr;
+  typedef ParticleBundle<typename S1::filter_state_type,
+      typename S1::filter_output_type> bundle_type;
 
-  /* pipeline first round of sends */
-  const int buf = 8;
-  for (p = 0; p < buf * size && p < P; ++p) {
-    if (p % size > 0) {
-      recvr = (rank + p) % size;
-      sends1[p] = world.isend(recvr, 2 * rank * p, *s.s1s[p]);
-      sends2[p] = world.isend(recvr, 2 * rank * p + 1, *s.out1s[p]);
-    }
-  }
+  boost::mpi::request req;
+  int p, d;
 
-  /* receive incoming one by one */
-  for (p = 0; p < P; ++p) {
-    if (p % size > 0) {
-      /* receive new particle for this position */
-      sendr = (rank + size - (p % size)) % size;
-      world.recv(sendr, 2 * sendr * p, s.s2);
-      world.recv(sendr, 2 * sendr * p + 1, s.out2);
-
-      /* ensure old particle in this position has been sent */
-      sends1[p].wait();
-      sends2[p].wait();
-
-      /* replace the old particle with the new particle */
-      s.s2.swap(*s.s1s[p]);
-      s.out2.swap(*s.out1s[p]);
-
-      /* continue the pipeline */
-      recvr = (rank + p) % size;
-      if (p + buf * size < P) {
-        sends1[p + buf * size] = world.isend(recvr,
-            2 * rank * (p + buf * size), *s.s1s[p]);
-        sends2[p + buf * size] = world.isend(recvr,
-            2 * rank * (p + buf * size) + 1, *s.out1s[p]);
-      }
+  /* in round d, positions p with p % size == d are exchanged with the
+   * processes d ranks away, one message each way */
+  for (d = 1; d < size && d < P; ++d) {
+    bundle_type bundle;
+    for (p = d; p < P; p += size) {
+      bundle.push_back(s.s1s[p], s.out1s[p]);
     }
+
+    /* the bundle is packed on the call to isend, so that the receive may
+     * overwrite its particles */
+    req = world.isend((rank + d) % size, MPI_TAG_PARTICLE, bundle);
+    world.recv((rank + size - d) % size, MPI_TAG_PARTICLE, bundle);
+    req.wait();
   }
 }
 
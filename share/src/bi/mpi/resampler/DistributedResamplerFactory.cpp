@@ -6,34 +6,34 @@
 #include "DistributedResamplerFactory.hpp"
 
 boost::shared_ptr<bi::DistributedResampler<bi::MultinomialResampler> > bi::DistributedResamplerFactory::createMultinomialResampler(
-    const double essRel, const bool anytime) {
+    const double essRel, const bool anytime, const bool island) {
   return boost::make_shared < DistributedResampler<MultinomialResampler>
-      > (essRel, anytime);
+      > (essRel, anytime, island);
 }
 
 boost::shared_ptr<bi::DistributedResampler<bi::StratifiedResampler> > bi::DistributedResamplerFactory::createStratifiedResampler(
-    const double essRel, const bool anytime) {
+    const double essRel, const bool anytime, const bool island) {
   return boost::make_shared < DistributedResampler<StratifiedResampler>
-      > (essRel, anytime);
+      > (essRel, anytime, island);
 }
 
 boost::shared_ptr<bi::DistributedResampler<bi::SystematicResampler> > bi::DistributedResamplerFactory::createSystematicResampler(
-    const double essRel, const bool anytime) {
+    const double essRel, const bool anytime, const bool island) {
   return boost::make_shared < DistributedResampler<SystematicResampler>
-      > (essRel, anytime);
+      > (essRel, anytime, island);
 }
 
 boost::shared_ptr<bi::DistributedResampler<bi::MetropolisResampler> > bi::DistributedResamplerFactory::createMetropolisResampler(
-    const int B, const double essRel, const bool anytime) {
+    const int B, const double essRel, const bool anytime, const bool island) {
   BOOST_AUTO(resam,
       boost::make_shared < DistributedResampler<MetropolisResampler>
-          > (essRel, anytime));
+          > (essRel, anytime, island));
   resam->setSteps(B);
   return resam;
 }
 
 boost::shared_ptr<bi::DistributedResampler<bi::RejectionResampler> > bi::DistributedResamplerFactory::createRejectionResampler(
-    const bool anytime) {
+    const bool anytime, const bool island) {
   return boost::make_shared < DistributedResampler<RejectionResampler>
-      > (1.0, anytime);
+      > (1.0, anytime, island);
 }
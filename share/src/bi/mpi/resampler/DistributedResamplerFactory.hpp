@@ -21,6 +21,10 @@ namespace bi {
  * Resampler factory.
  *
  * @ingroup method_resampler
+ *
+ * Each resampler may use either the default strategy, computing offspring on
+ * the root process, or island mode, selected with the @p island argument.
+ * See DistributedResampler.
  */
 class DistributedResamplerFactory {
 public:
@@ -28,31 +32,35 @@ public:
    * Create multinomial resampler.
    */
   static boost::shared_ptr<DistributedResampler<MultinomialResampler> > createMultinomialResampler(
-      const double essRel = 0.5, const bool anytime = false);
+      const double essRel = 0.5, const bool anytime = false,
+      const bool island = false);
 
   /**
    * Create stratified resampler.
    */
   static boost::shared_ptr<DistributedResampler<StratifiedResampler> > createStratifiedResampler(
-      const double essRel = 0.5, const bool anytime = false);
+      const double essRel = 0.5, const bool anytime = false,
+      const bool island = false);
 
   /**
    * Create systematic resampler.
    */
   static boost::shared_ptr<DistributedResampler<SystematicResampler> > createSystematicResampler(
-      const double essRel = 0.5, const bool anytime = false);
+      const double essRel = 0.5, const bool anytime = false,
+      const bool island = false);
 
   /**
    * Create Metropolis resampler.
    */
   static boost::shared_ptr<DistributedResampler<MetropolisResampler> > createMetropolisResampler(
-      const int B, const double essRel = 0.5, const bool anytime = false);
+      const int B, const double essRel = 0.5, const bool anytime = false,
+      const bool island = false);
 
   /**
    * Create rejection resampler.
    */
   static boost::shared_ptr<DistributedResampler<RejectionResampler> > createRejectionResampler(
-      const bool anytime = false);
+      const bool anytime = false, const bool island = false);
 };
 }
 
@@ -0,0 +1,187 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_MPI_SAMPLER_DISTRIBUTEDPARALLELTEMPERING_HPP
+#define BI_MPI_SAMPLER_DISTRIBUTEDPARALLELTEMPERING_HPP
+
+#include "../../sampler/ParallelTempering.hpp"
+
+namespace bi {
+/**
+ * Parallel tempering, distributed using MPI.
+ *
+ * @ingroup method_sampler
+ *
+ * @tparam B Model type
+ * @tparam F Filter type.
+ *
+ * Each process holds a contiguous block of the temperature ladder, with the
+ * cold chain on the process of rank zero, which alone produces output. Local
+ * chains step and exchange as in ParallelTempering. Exchanges across the
+ * boundary between processes are decided by the lower process, after which
+ * the two chain states are swapped between them.
+ */
+template<class B, class F>
+class DistributedParallelTempering: public ParallelTempering<B,F> {
+public:
+  /**
+   * @copydoc ParallelTempering::ParallelTempering()
+   */
+  DistributedParallelTempering(B& m, F& filter,
+      const double maxTemperature = 10.0, const double rho = 0.0);
+
+  /**
+   * @copydoc ParallelTempering::sample()
+   */
+  template<class S1, class IO1, class IO2>
+  void sample(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, const int C, IO1& out, IO2& inInit);
+
+  /**
+   * Propose exchanges between adjacent chains, including those on adjacent
+   * processes.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param c Step index.
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void exchange(Random& rng, const int c, S1& s);
+
+  /**
+   * @copydoc ParallelTempering::output()
+   */
+  template<class S1, class IO1>
+  void output(const int c, const S1& s, IO1& out);
+
+private:
+  /**
+   * Swap current state of chain with that of another process. The proposal
+   * state of the chain is used as the receive buffer.
+   *
+   * @tparam S1 Chain state type.
+   *
+   * @param rank Rank of other process.
+   * @param[in,out] chain Chain state.
+   */
+  template<class S1>
+  static void swap(const int rank, S1& chain);
+};
+}
+
+#include "../mpi.hpp"
+#include "../../misc/TicToc.hpp"
+
+#include <list>
+
+template<class B, class F>
+bi::DistributedParallelTempering<B,F>::DistributedParallelTempering(B& m,
+    F& filter, const double maxTemperature, const double rho) :
+    ParallelTempering<B,F>(m, filter, maxTemperature, rho) {
+  //
+}
+
+template<class B, class F>
+template<class S1, class IO1, class IO2>
+void bi::DistributedParallelTempering<B,F>::sample(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    const int C, IO1& out, IO2& inInit) {
+  /* pre-condition */
+  BI_ERROR(C > 0);
+
+  boost::mpi::communicator world;
+  const int rank = world.rank();
+  const int size = world.size();
+  const int K = s.size();
+
+  TicToc clock;
+  this->init(rng, first, last, s, inInit, rank * K, size * K);
+  output(0, s, out);
+  for (int c = 1; c < C; ++c) {
+    this->step(rng, first, last, s);
+    exchange(rng, c, s);
+    if (rank == 0) {
+      this->report(c, s);
+    }
+    output(c, s, out);
+  }
+  s.clock = clock.toc();
+  this->outputT(s, out);
+  this->term();
+}
+
+template<class B, class F>
+template<class S1>
+void bi::DistributedParallelTempering<B,F>::exchange(Random& rng,
+    const int c, S1& s) {
+  boost::mpi::communicator world;
+  const int rank = world.rank();
+  const int size = world.size();
+  const int K = s.size();
+  const int k0 = rank * K;
+
+  /* chains local to this process */
+  ParallelTempering<B,F>::exchange(rng, c, s, k0);
+
+  /* chains across the boundaries with adjacent processes */
+  const bool lower = rank + 1 < size && (k0 + K - 1) % 2 == c % 2;
+  const bool upper = rank > 0 && (k0 - 1) % 2 == c % 2;
+  std::list<boost::mpi::request> reqs;
+  double ll, logratio;
+  bool acceptLower = false, acceptUpper = false;
+
+  if (upper) {
+    reqs.push_back(
+        world.isend(rank - 1, MPI_TAG_TEMPERING_LOGLIKELIHOOD,
+            s.select(0).s1.logLikelihood));
+  }
+  if (lower) {
+    world.recv(rank + 1, MPI_TAG_TEMPERING_LOGLIKELIHOOD, ll);
+    logratio = this->logExchangeRatio(
+        this->mhs[K - 1]->getInverseTemperature(),
+        this->inverseTemperature(k0 + K, size * K),
+        s.select(K - 1).s1.logLikelihood, ll);
+    acceptLower = bi::log(rng.uniform<double>()) < logratio;
+    reqs.push_back(
+        world.isend(rank + 1, MPI_TAG_TEMPERING_ACCEPT, acceptLower));
+    if (acceptLower) {
+      swap(rank + 1, s.select(K - 1));
+      ++this->exchanges[K - 1];
+    }
+    ++this->proposals[K - 1];
+  }
+  if (upper) {
+    world.recv(rank - 1, MPI_TAG_TEMPERING_ACCEPT, acceptUpper);
+    if (acceptUpper) {
+      swap(rank - 1, s.select(0));
+    }
+  }
+  boost::mpi::wait_all(reqs.begin(), reqs.end());
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::DistributedParallelTempering<B,F>::output(const int c, const S1& s,
+    IO1& out) {
+  boost::mpi::communicator world;
+  if (world.rank() == 0) {
+    ParallelTempering<B,F>::output(c, s, out);
+  }
+}
+
+template<class B, class F>
+template<class S1>
+void bi::DistributedParallelTempering<B,F>::swap(const int rank, S1& chain) {
+  boost::mpi::communicator world;
+  boost::mpi::request req = world.isend(rank, MPI_TAG_TEMPERING_STATE,
+      chain.s1);
+  world.recv(rank, MPI_TAG_TEMPERING_STATE, chain.s2);
+  req.wait();
+  chain.s1.swap(chain.s2);
+}
+
+#endif
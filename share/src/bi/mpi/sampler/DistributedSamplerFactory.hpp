@@ -0,0 +1,39 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_MPI_SAMPLER_DISTRIBUTEDSAMPLERFACTORY_HPP
+#define BI_MPI_SAMPLER_DISTRIBUTEDSAMPLERFACTORY_HPP
+
+#include "DistributedParallelTempering.hpp"
+
+#include "boost/shared_ptr.hpp"
+
+namespace bi {
+/**
+ * Sampler factory.
+ *
+ * @ingroup method_sampler
+ */
+class DistributedSamplerFactory {
+public:
+  /**
+   * Create parallel tempering sampler.
+   */
+  template<class B, class F>
+  static boost::shared_ptr<DistributedParallelTempering<B,F> > createParallelTempering(
+      B& m, F& filter, const double maxTemperature = 10.0,
+      const double rho = 0.0);
+};
+}
+
+template<class B, class F>
+boost::shared_ptr<bi::DistributedParallelTempering<B,F> > bi::DistributedSamplerFactory::createParallelTempering(
+    B& m, F& filter, const double maxTemperature, const double rho) {
+  return boost::shared_ptr < DistributedParallelTempering<B,F>
+      > (new DistributedParallelTempering<B,F>(m, filter, maxTemperature,
+          rho));
+}
+
+#endif
@@ -101,6 +101,20 @@ void bi::InputNetCDFBuffer::readMask0(const VarType type,
   }
 }
 
+void bi::InputNetCDFBuffer::reopen() {
+  nc_close(ncid);
+  ncid = nc_open(file, NC_NOWRITE);
+
+  /* random access tables are kept, and only extended by scan() */
+  recDims.clear();
+  timeVars.clear();
+  coordVars.clear();
+  modelVars.clear();
+  vars.clear();
+  vars.resize(NUM_VAR_TYPES);
+  map();
+}
+
 void bi::InputNetCDFBuffer::map() {
   int ncDim, ncVar;
   Var* var;
@@ -191,14 +205,22 @@ void bi::InputNetCDFBuffer::map() {
   }
 
   /* preload random access tables */
+  scan();
+}
+
+void bi::InputNetCDFBuffer::scan() {
   std::multimap<real,int> seq;
-  std::vector<size_t> starts(recDims.size(), 0), lens(recDims.size(), 0);
+  std::vector<size_t> lens(recDims.size(), 0);
+  std::vector<size_t>& starts = recNext;
   real tnxt;
+  int ncDim, ncVar, k;
 
+  starts.resize(recDims.size(), 0);
   for (k = 0; k < int(recDims.size()); ++k) {
-    if (timeVars[k] >= 0 && modelVars.count(k) > 0) {
+    if (timeVars[k] >= 0 && modelVars.count(k) > 0
+        && starts[k] < nc_inq_dimlen(ncid, recDims[k])) {
       /* ^ ignores record dimensions with no associated time or model
-       *   variables */
+       *   variables, or no records not already scanned */
       readTime(timeVars[k], starts[k], &lens[k], &tnxt);
       seq.insert(std::make_pair(tnxt, k));
     }
@@ -212,13 +234,21 @@ void bi::InputNetCDFBuffer::map() {
     ncDim = recDims[k];
     ncVar = timeVars[k];
 
+    BI_ERROR_MSG(times.empty() || times.back() <= tnxt,
+        "Records in " << file << " must be in time order, and only appended");
     if (times.empty() || times.back() != tnxt) {
       times.push_back(tnxt);
       recStarts.push_back(std::vector < size_t > (recDims.size(), 0));
       recLens.push_back(std::vector < size_t > (recDims.size(), 0));
     }
-    recStarts.back()[k] = starts[k];
-    recLens.back()[k] = lens[k];
+    if (recLens.back()[k] > 0) {
+      /* records appended at the last time already read, contiguous with
+       * those read before */
+      recLens.back()[k] += lens[k];
+    } else {
+      recStarts.back()[k] = starts[k];
+      recLens.back()[k] = lens[k];
+    }
 
     /* read next time and range for this time variable */
     starts[k] += lens[k];
@@ -44,6 +44,11 @@ public:
    */
   real getTime(const size_t k);
 
+  /**
+   * @copydoc InputBuffer::numTimes()
+   */
+  size_t numTimes() const;
+
   /**
    * @copydoc InputBuffer::readTimes()
    */
@@ -85,6 +90,17 @@ public:
   template<class M1>
   void read0(const VarType type, M1 X);
 
+  /**
+   * Reopen file and map its structure again, to pick up records appended
+   * since it was last opened.
+   *
+   * Records must only be appended, in time order: only records after those
+   * already read are scanned, and time indices of existing records are
+   * preserved, so that caches indexed by them remain valid. The writer
+   * should close or synchronise the file between appends.
+   */
+  void reopen();
+
 protected:
   /**
    * Read from time variable.
@@ -161,6 +177,11 @@ protected:
    */
   void map();
 
+  /**
+   * Extend random access tables with records not yet scanned.
+   */
+  void scan();
+
   /**
    * Map variable in existing NetCDF file.
    *
@@ -218,6 +239,11 @@ protected:
    */
   std::vector<std::vector<size_t> > recLens;
 
+  /**
+   * Offsets of the next unscanned record along record dimensions.
+   */
+  std::vector<size_t> recNext;
+
   /**
    * Time variables, by record dimension index, NULL where none.
    */
@@ -276,6 +302,10 @@ inline real bi::InputNetCDFBuffer::getTime(const size_t k) {
   return times[k];
 }
 
+inline size_t bi::InputNetCDFBuffer::numTimes() const {
+  return times.size();
+}
+
 template<class T1>
 inline void bi::InputNetCDFBuffer::readTimes(std::vector<T1>& ts) {
   ts = times;
@@ -48,3 +48,19 @@ void bi::MCMCNetCDFBuffer::map() {
   BI_ERROR_MSG(dimids[0] == npDim,
       "Only dimension of variable logprior should be np, in file " << file);
 }
+
+int bi::MCMCNetCDFBuffer::countSamples() {
+  return nc_inq_dimlen(ncid, npDim);
+}
+
+real bi::MCMCNetCDFBuffer::readLogLikelihood(const size_t p) {
+  real ll;
+  nc_get_vara(ncid, llVar, p, 1, &ll);
+  return ll;
+}
+
+real bi::MCMCNetCDFBuffer::readLogPrior(const size_t p) {
+  real lp;
+  nc_get_vara(ncid, lpVar, p, 1, &lp);
+  return lp;
+}
@@ -50,6 +50,29 @@ public:
   template<class V1>
   void writeLogPriors(const size_t p, const V1 lp);
 
+  /**
+   * Count samples already in file, i.e. the length of the @c np dimension.
+   */
+  int countSamples();
+
+  /**
+   * Read log-likelihood.
+   *
+   * @param p Sample index.
+   *
+   * @return Log-likelihood.
+   */
+  real readLogLikelihood(const size_t p);
+
+  /**
+   * Read log-prior density.
+   *
+   * @param p Sample index.
+   *
+   * @return Log-prior density.
+   */
+  real readLogPrior(const size_t p);
+
 protected:
   /**
    * Set up structure of NetCDF file.
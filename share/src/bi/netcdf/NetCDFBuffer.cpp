@@ -8,10 +8,11 @@
 #include "../misc/assert.hpp"
 
 bi::NetCDFBuffer::NetCDFBuffer(const std::string& file, const FileMode mode) :
-    file(file), ncid(-1) {
+    file(file), mode(mode), ncid(-1) {
   BI_ERROR_MSG(!file.empty(), "No file specified");
   switch (mode) {
   case WRITE:
+  case APPEND:
     ncid = nc_open(file, NC_WRITE);
     break;
   case NEW:
@@ -28,7 +29,7 @@ bi::NetCDFBuffer::NetCDFBuffer(const std::string& file, const FileMode mode) :
 }
 
 bi::NetCDFBuffer::NetCDFBuffer(const NetCDFBuffer& o) :
-    file(o.file), ncid(-1) {
+    file(o.file), mode(READ_ONLY), ncid(-1) {
   if (!file.empty()) {
     ncid = nc_open(file, NC_NOWRITE);
   }
@@ -42,3 +43,7 @@ bi::NetCDFBuffer::~NetCDFBuffer() {
 void bi::NetCDFBuffer::clear() {
   //
 }
+
+void bi::NetCDFBuffer::sync() {
+  nc_sync(ncid);
+}
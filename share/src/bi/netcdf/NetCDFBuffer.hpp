@@ -43,6 +43,11 @@ public:
    */
   void clear();
 
+  /**
+   * Synchronise file on disk with everything written so far.
+   */
+  void sync();
+
 protected:
   /**
    * NetCDF file name recorded by constructor. Using this is preferred to the
@@ -51,6 +56,11 @@ protected:
    */
   std::string file;
 
+  /**
+   * File open mode.
+   */
+  FileMode mode;
+
   /**
    * NetCDF file id.
    */
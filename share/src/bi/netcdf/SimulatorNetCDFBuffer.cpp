@@ -11,8 +11,8 @@ bi::SimulatorNetCDFBuffer::SimulatorNetCDFBuffer(const Model& m,
     const size_t P, const size_t T, const std::string& file,
     const FileMode mode, const SchemaMode schema) :
     NetCDFBuffer(file, mode), m(m), schema(schema), nsDim(-1), nrDim(-1), npDim(
-        -1), nrpDim(-1), tVar(-1), startVar(-1), lenVar(-1), k(-1), start(0), len(
-        0), vars(NUM_VAR_TYPES) {
+        -1), nrpDim(-1), tVar(-1), timerVars(NUM_PHASES, -1), startVar(-1), lenVar(
+        -1), k(-1), start(0), len(0), vars(NUM_VAR_TYPES) {
   if (mode == NEW || mode == REPLACE) {
     create(P, T);
   } else {
@@ -21,6 +21,7 @@ bi::SimulatorNetCDFBuffer::SimulatorNetCDFBuffer(const Model& m,
 }
 
 void bi::SimulatorNetCDFBuffer::create(const size_t P, const size_t T) {
+  std::string name;
   int id, i;
   VarType type;
   Var* var;
@@ -82,9 +83,15 @@ void bi::SimulatorNetCDFBuffer::create(const size_t P, const size_t T) {
       }
     }
   }
+  /* execution time variables */
   clockVar = nc_def_var(ncid, "clock", NC_INT64);
+  if (schema != PARAM_ONLY) {
+    for (i = 0; i < NUM_PHASES; ++i) {
+      name = std::string("clock_") + PhaseTimer::getName(static_cast<Phase>(i));
+      timerVars[i] = nc_def_var(ncid, name, NC_INT64, nrDim);
+    }
+  }
 
-  /* execution time variable */
   nc_enddef(ncid);
 }
 
@@ -109,7 +116,7 @@ void bi::SimulatorNetCDFBuffer::map(const size_t P, const size_t T) {
   } else {
     npDim = nc_inq_dimid(ncid, "np");
     BI_ERROR_MSG(npDim >= 0, "No dimension np or nrp in file " << file);
-    BI_ERROR_MSG(P < 0 || nc_inq_dimlen(ncid, npDim) == P,
+    BI_ERROR_MSG(mode == APPEND || nc_inq_dimlen(ncid, npDim) == P,
         "Dimension np has length " << nc_inq_dimlen(ncid, npDim) << ", should be of length " << P << ", in file " << file);
   }
 
@@ -162,6 +169,17 @@ void bi::SimulatorNetCDFBuffer::map(const size_t P, const size_t T) {
   dimids = nc_inq_vardimid(ncid, clockVar);
   BI_ERROR_MSG(dimids.size() == 0u,
       "Variable clock has " << dimids.size() << " dimensions, should have 0, in file " << file);
+
+  /* execution time by phase variables, optional */
+  for (i = 0; i < NUM_PHASES; ++i) {
+    name = std::string("clock_") + PhaseTimer::getName(static_cast<Phase>(i));
+    timerVars[i] = nc_inq_varid(ncid, name);
+    if (timerVars[i] >= 0) {
+      dimids = nc_inq_vardimid(ncid, timerVars[i]);
+      BI_ERROR_MSG(dimids.size() == 1u && dimids[0] == nrDim,
+          "Only dimension of variable " << name << " should be nr, in file " << file);
+    }
+  }
 }
 
 int bi::SimulatorNetCDFBuffer::createVar(Var* var) {
@@ -277,3 +295,14 @@ void bi::SimulatorNetCDFBuffer::writeLen(const size_t k, const long& len) {
 void bi::SimulatorNetCDFBuffer::writeClock(const long clock) {
   nc_put_var(ncid, clockVar, &clock);
 }
+
+void bi::SimulatorNetCDFBuffer::writeTimer(const size_t k,
+    const PhaseTimer& timer) {
+  long usecs;
+  for (int i = 0; i < NUM_PHASES; ++i) {
+    if (timerVars[i] >= 0) {
+      usecs = timer.get(static_cast<Phase>(i));
+      nc_put_var1(ncid, timerVars[i], k, &usecs);
+    }
+  }
+}
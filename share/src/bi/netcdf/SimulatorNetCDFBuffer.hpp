@@ -9,6 +9,7 @@
 #include "NetCDFBuffer.hpp"
 #include "../model/Model.hpp"
 #include "../state/ScheduleElement.hpp"
+#include "../misc/PhaseTimer.hpp"
 
 #include <vector>
 
@@ -127,6 +128,48 @@ public:
   void writeStateVar(const VarType type, const int id, const size_t k,
       const size_t p, const M1 X);
 
+  /**
+   * Read static parameters.
+   *
+   * @tparam M1 Matrix type.
+   *
+   * @param p First sample index.
+   * @param[out] X Parameters. Rows index samples, columns variables.
+   */
+  template<class M1>
+  void readParameters(const size_t p, M1 X);
+
+  /**
+   * Read state.
+   *
+   * @tparam M1 Matrix type.
+   *
+   * @param type Variable type.
+   * @param k Time index.
+   * @param p First sample index.
+   * @param[out] X State. Rows index samples, columns variables.
+   *
+   * Variables without output are left unchanged. Not supported for flexi
+   * schemas.
+   */
+  template<class M1>
+  void readState(const VarType type, const size_t k, const size_t p, M1 X);
+
+  /**
+   * Read state variable.
+   *
+   * @tparam M1 Matrix type.
+   *
+   * @param type Variable type.
+   * @param id Variable id.
+   * @param k Time index.
+   * @param p First sample index.
+   * @param[out] X State. Rows index samples, columns variables.
+   */
+  template<class M1>
+  void readStateVar(const VarType type, const int id, const size_t k,
+      const size_t p, M1 X);
+
   /**
    * Write offset along @c nrp dimension for time. Flexi schema only.
    *
@@ -150,6 +193,17 @@ public:
    */
   void writeClock(const long clock);
 
+  /**
+   * Write execution time by phase.
+   *
+   * @param k Time index.
+   * @param timer Execution time by phase, accumulated to time index @p k.
+   *
+   * Files created by earlier versions have no such variables, in which
+   * case nothing is written.
+   */
+  void writeTimer(const size_t k, const PhaseTimer& timer);
+
 protected:
   /**
    * Set up structure of NetCDF file.
@@ -279,6 +333,11 @@ protected:
    */
   int clockVar;
 
+  /**
+   * Execution time by phase variables, -1 where absent.
+   */
+  std::vector<int> timerVars;
+
   /**
    * Variable holding starting index into nrp dimension for each time, flexi
    * schema only.
@@ -430,6 +489,73 @@ void bi::SimulatorNetCDFBuffer::writeStateVar(const VarType type,
   }
 }
 
+template<class M1>
+void bi::SimulatorNetCDFBuffer::readParameters(const size_t p, M1 X) {
+  readState(P_VAR, 0, p, X);
+}
+
+template<class M1>
+void bi::SimulatorNetCDFBuffer::readState(const VarType type, const size_t k,
+    const size_t p, M1 X) {
+  /* pre-condition */
+  BI_ERROR_MSG(schema != FLEXI, "reads not supported with flexible schemas");
+
+  Var* var;
+  int id, start, size;
+
+  for (id = 0; id < m.getNumVars(type); ++id) {
+    var = m.getVar(type, id);
+    start = var->getStart();
+    size = var->getSize();
+    readStateVar(type, id, k, p, columns(X, start, size));
+  }
+}
+
+template<class M1>
+void bi::SimulatorNetCDFBuffer::readStateVar(const VarType type,
+    const int id, const size_t k, const size_t p, M1 X) {
+  typedef typename sim_temp_host_matrix<M1>::type temp_matrix_type;
+
+  Var* var = m.getVar(type, id);
+  std::vector<size_t> offsets, counts;
+  std::vector<int> dimids;
+  int i, j, varid;
+
+  if (var->hasOutput()) {
+    varid = vars[type][id];
+    BI_ASSERT(varid >= 0);
+
+    j = 0;
+    dimids = nc_inq_vardimid(ncid, varid);
+    offsets.resize(dimids.size());
+    counts.resize(dimids.size());
+
+    if (j < static_cast<int>(dimids.size()) && dimids[j] == nrDim) {
+      offsets[j] = k;
+      counts[j] = 1;
+      ++j;
+    }
+    for (i = var->getNumDims() - 1; i >= 0; --i) {
+      offsets[j] = 0;
+      counts[j] = nc_inq_dimlen(ncid, dimids[j]);
+      ++j;
+    }
+    if (j < static_cast<int>(dimids.size()) && dimids[j] == npDim) {
+      offsets[j] = p;
+      counts[j] = X.size1();
+      ++j;
+    }
+
+    if (M1::on_device || !X.contiguous()) {
+      temp_matrix_type X1(X.size1(), X.size2());
+      nc_get_vara(ncid, varid, offsets, counts, X1.buf());
+      X = X1;
+    } else {
+      nc_get_vara(ncid, varid, offsets, counts, X.buf());
+    }
+  }
+}
+
 template<class V1>
 void bi::SimulatorNetCDFBuffer::writeRange(const int varid, const size_t k,
     const V1 x) {
@@ -30,6 +30,11 @@ public:
    */
   real getTime(const size_t k);
 
+  /**
+   * @copydoc InputBuffer::numTimes()
+   */
+  size_t numTimes() const;
+
   /**
    * @copydoc InputBuffer::readTimes()
    */
@@ -77,6 +82,10 @@ inline real bi::InputNullBuffer::getTime(const size_t k) {
   BI_ERROR_MSG(false, "time index outside valid range");
 }
 
+inline size_t bi::InputNullBuffer::numTimes() const {
+  return 0;
+}
+
 template<class T1>
 inline void bi::InputNullBuffer::readTimes(std::vector<T1>& ts) {
   ts.clear();
@@ -11,3 +11,17 @@ bi::MCMCNullBuffer::MCMCNullBuffer(const Model& m, const size_t P,
     SimulatorNullBuffer(m, P, T, file, mode, schema) {
   //
 }
+
+int bi::MCMCNullBuffer::countSamples() {
+  return 0;
+}
+
+real bi::MCMCNullBuffer::readLogLikelihood(const size_t p) {
+  BI_ERROR_MSG(false, "No samples in null buffer");
+  return 0.0;
+}
+
+real bi::MCMCNullBuffer::readLogPrior(const size_t p) {
+  BI_ERROR_MSG(false, "No samples in null buffer");
+  return 0.0;
+}
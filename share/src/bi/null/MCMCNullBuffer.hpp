@@ -34,6 +34,21 @@ public:
    */
   template<class V1>
   void writeLogPriors(const size_t p, const V1 lp);
+
+  /**
+   * @copydoc MCMCNetCDFBuffer::countSamples()
+   */
+  int countSamples();
+
+  /**
+   * @copydoc MCMCNetCDFBuffer::readLogLikelihood()
+   */
+  real readLogLikelihood(const size_t p);
+
+  /**
+   * @copydoc MCMCNetCDFBuffer::readLogPrior()
+   */
+  real readLogPrior(const size_t p);
 };
 }
 
@@ -26,3 +26,12 @@ void bi::SimulatorNullBuffer::writeLen(const size_t k, const long& len) {
 void bi::SimulatorNullBuffer::writeClock(const long clock) {
   //
 }
+
+void bi::SimulatorNullBuffer::writeTimer(const size_t k,
+    const PhaseTimer& timer) {
+  //
+}
+
+void bi::SimulatorNullBuffer::sync() {
+  //
+}
@@ -9,6 +9,8 @@
 #include "../model/Model.hpp"
 #include "../buffer/buffer.hpp"
 #include "../math/scalar.hpp"
+#include "../misc/assert.hpp"
+#include "../misc/PhaseTimer.hpp"
 
 namespace bi {
 /**
@@ -90,6 +92,22 @@ public:
    * @param clock Execution time.
    */
   void writeClock(const long clock);
+
+  /**
+   * @copydoc SimulatorNetCDFBuffer::writeTimer()
+   */
+  void writeTimer(const size_t k, const PhaseTimer& timer);
+
+  /**
+   * @copydoc SimulatorNetCDFBuffer::readParameters()
+   */
+  template<class M1>
+  void readParameters(const size_t p, M1 X);
+
+  /**
+   * @copydoc NetCDFBuffer::sync()
+   */
+  void sync();
 };
 }
 
@@ -98,6 +116,11 @@ void bi::SimulatorNullBuffer::writeTimes(const size_t k, const V1 ts) {
   //
 }
 
+template<class M1>
+void bi::SimulatorNullBuffer::readParameters(const size_t p, M1 X) {
+  BI_ERROR_MSG(false, "No samples in null buffer");
+}
+
 template<class M1>
 void bi::SimulatorNullBuffer::writeParameters(M1 X) {
   //
@@ -8,6 +8,7 @@
 
 #include "../state/Schedule.hpp"
 #include "../state/State.hpp"
+#include "../random/Random.hpp"
 #include "../math/gsl.hpp"
 
 #include <gsl/gsl_multimin.h>
@@ -79,6 +80,7 @@ struct NelderMeadOptimiserParams {
   IO1* out;
   IO2* in;
   ScheduleIterator first, last;
+  bool crn;
 };
 
 /**
@@ -88,6 +90,12 @@ struct NelderMeadOptimiserParams {
  *
  * @tparam B Model type
  * @tparam F #concept::Filter type.
+ *
+ * With common random numbers, the filter draws from its own random number
+ * generator, reset to the start of the same streams for each evaluation of
+ * the objective. The estimate of the objective is then a deterministic
+ * function of the parameters. Combine with sorted resampling
+ * (Resampler::setSort()) so that this function is close to continuous.
  */
 template<class B, class F>
 class NelderMeadOptimiser {
@@ -106,10 +114,12 @@ public:
    * @param filter Filter.
    * @param out Output.
    * @param mode Mode of operation.
+   * @param crn Use common random numbers?
    *
    * @see BootstrapPF
    */
-  NelderMeadOptimiser(B& m, F& filter, const OptimiserMode mode = MAXIMUM_LIKELIHOOD);
+  NelderMeadOptimiser(B& m, F& filter, const OptimiserMode mode =
+      MAXIMUM_LIKELIHOOD, const bool crn = false);
 
   /**
    * @name High-level interface
@@ -224,6 +234,16 @@ private:
    */
   OptimiserMode mode;
 
+  /**
+   * Use common random numbers?
+   */
+  bool crn;
+
+  /**
+   * Random number generator for filter when using common random numbers.
+   */
+  Random rngFilter;
+
   /**
    * Current state.
    */
@@ -262,8 +282,8 @@ struct NelderMeadOptimiserFactory {
    */
   template<class B, class F>
   static NelderMeadOptimiser<B,F>* create(B& m, F& filter,
-      const OptimiserMode mode = MAXIMUM_LIKELIHOOD) {
-    return new NelderMeadOptimiser<B,F>(m, filter, mode);
+      const OptimiserMode mode = MAXIMUM_LIKELIHOOD, const bool crn = false) {
+    return new NelderMeadOptimiser<B,F>(m, filter, mode, crn);
   }
 };
 }
@@ -275,10 +295,12 @@ struct NelderMeadOptimiserFactory {
 
 #include "../misc/TicToc.hpp"
 
+#include <limits>
+
 template<class B, class F>
 bi::NelderMeadOptimiser<B,F>::NelderMeadOptimiser(B& m, F& filter,
-    const OptimiserMode mode) :
-    m(m), filter(filter), mode(mode), state(B::NP) {
+    const OptimiserMode mode, const bool crn) :
+    m(m), filter(filter), mode(mode), crn(crn), state(B::NP) {
   //
 }
 
@@ -317,16 +339,22 @@ void bi::NelderMeadOptimiser<B,F>::init(Random& rng,
   mulscal_elements(gsl_vector_reference(state.step), simplexSizeRel,
       gsl_vector_reference(state.step));
 
+  /* common random numbers */
+  if (crn) {
+    rngFilter.seeds(rng.uniformInt(0, std::numeric_limits<int>::max()));
+  }
+
   /* parameters */
   NelderMeadOptimiserParams<B,F,S,IO1,IO2>* params = new NelderMeadOptimiserParams<B,F,S,IO1,IO2>();  ///@todo Leaks
   params->m = &m;
-  params->rng = &rng;
+  params->rng = crn ? &rngFilter : &rng;
   params->s = &s;
   params->filter = &filter;
   params->out = &out;
   params->in = &inInit;
   params->first = first;
   params->last = last;
+  params->crn = crn;
 
   /* function */
   gsl_multimin_function* f = new gsl_multimin_function();  ///@todo Leaks
@@ -383,9 +411,17 @@ double bi::NelderMeadOptimiser<B,F>::ml(const gsl_vector* x,
   typedef NelderMeadOptimiserParams<B,F,S,IO1,IO2> param_type;
   param_type* p = reinterpret_cast<param_type*>(params);
 
+  /* initialise */
+  if (p->crn) {
+    p->rng->reset();
+  }
+  p->filter->init(*p->rng, *(p->first), *p->s, *p->out, *p->in);
+  vec(p->s->get(P_VAR)) = gsl_vector_reference(x);
+  p->s->get(PY_VAR) = p->s->get(P_VAR);
+  p->m->initialSamples(*p->rng, *p->s);
+
   /* evaluate */
   try {
-    p->filter->init(*p->rng, *(p->first), *p->s, *p->out, *p->in);
     p->filter->filter(*p->rng, p->first, p->last, *p->s, *p->out);
     real ll = (*p->s).logLikelihood;
     return -ll;
@@ -403,23 +439,26 @@ double bi::NelderMeadOptimiser<B,F>::map(const gsl_vector* x,
   typedef NelderMeadOptimiserParams<B,F,S,IO1,IO2> param_type;
   param_type* p = reinterpret_cast<param_type*>(params);
 
-  int P = p->s->size();
-  p->s->resizeMax(1, true);
-
   /* initialise */
-  vec(p->s->get(PY_VAR)) = gsl_vector_reference(x);
+  if (p->crn) {
+    p->rng->reset();
+  }
+  p->filter->init(*p->rng, *(p->first), *p->s, *p->out, *p->in);
+  vec(p->s->get(P_VAR)) = gsl_vector_reference(x);
+  p->s->get(PY_VAR) = p->s->get(P_VAR);
   real lp = p->m->parameterLogDensity(*p->s);
-  p->s->resizeMax(P, true);
+  p->m->initialSamples(*p->rng, *p->s);
 
   /* evaluate */
   if (bi::is_finite(lp)) {
     try {
-      p->filter->init(*p->rng, *(p->first), *p->s, *p->out, *p->in);
       p->filter->filter(*p->rng, p->first, p->last, *p->s, *p->out);
       real ll = (*p->s).logLikelihood;
       return -(ll + lp);
     } catch (CholeskyException e) {
       return GSL_NAN;
+    } catch (ParticleFilterDegeneratedException e) {
+      return GSL_NAN;
     }
   } else {
     return GSL_NAN;
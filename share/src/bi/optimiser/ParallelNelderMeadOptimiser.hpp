@@ -0,0 +1,711 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_OPTIMISER_PARALLELNELDERMEADOPTIMISER_HPP
+#define BI_OPTIMISER_PARALLELNELDERMEADOPTIMISER_HPP
+
+#include "misc.hpp"
+#include "../state/Schedule.hpp"
+#include "../random/Random.hpp"
+#include "../null/InputNullBuffer.hpp"
+#include "../math/vector.hpp"
+#include "../math/matrix.hpp"
+
+#include <algorithm>
+
+namespace bi {
+/**
+ * @internal
+ *
+ * %State of ParallelNelderMeadOptimiser.
+ */
+struct ParallelNelderMeadOptimiserState {
+  /**
+   * Constructor.
+   *
+   * @param N Number of parameters.
+   * @param K Number of starts.
+   */
+  ParallelNelderMeadOptimiserState(const int N, const int K);
+
+  /**
+   * Simplices. Vertex @c i of start @c k is row <tt>k*(N + 1) + i</tt>,
+   * with vertices of each start sorted by increasing cost.
+   */
+  host_matrix<real> X;
+
+  /**
+   * Costs of vertices.
+   */
+  host_vector<real> f;
+
+  /**
+   * Candidate points.
+   */
+  host_matrix<real> C;
+
+  /**
+   * Costs of candidate points.
+   */
+  host_vector<real> fc;
+
+  /**
+   * Size of each simplex.
+   */
+  host_vector<real> size;
+
+  /**
+   * Index of start with lowest cost.
+   */
+  int best;
+};
+}
+
+inline bi::ParallelNelderMeadOptimiserState::ParallelNelderMeadOptimiserState(
+    const int N, const int K) :
+    X(K*(N + 1), N), f(K*(N + 1)), C(K*std::max(4, N), N), fc(
+        K*std::max(4, N)), size(K), best(0) {
+  //
+}
+
+namespace bi {
+/**
+ * Nelder-Mead simplex optimisation, with concurrent evaluation of the
+ * objective.
+ *
+ * @ingroup method_optimiser
+ *
+ * @tparam B Model type
+ * @tparam F #concept::Filter type.
+ *
+ * Each step of the Nelder-Mead method evaluates the objective at one of
+ * four points along the line through the worst vertex and the centroid of
+ * the others: reflection, expansion, outside or inside contraction. All
+ * four are evaluated speculatively, and concurrently, before the usual
+ * rules choose between them; only a shrink requires a second round of
+ * evaluations, of all but the best vertex, also concurrently.
+ *
+ * A number of independent simplices (starts) may be optimised together.
+ * The first begins from the initialisation file (or the prior, if none is
+ * given), the remainder from the prior. The evaluations of all starts are
+ * scheduled together on the available threads, each thread with its own
+ * filter state and output. Under MPI, starts are distributed between
+ * processes.
+ *
+ * Output is in the same format as NelderMeadOptimiser, recording the best
+ * vertex over all starts at each step. Under MPI, processes step together
+ * until the starts of all have converged, and each outputs the best vertex
+ * over all processes.
+ *
+ * With common random numbers, each evaluation resets the random number
+ * generator of its thread to the start of the same stream
+ * (Random::resetCommon()), so that the estimate of the objective is a
+ * deterministic function of the parameters, whichever thread evaluates it.
+ */
+template<class B, class F>
+class ParallelNelderMeadOptimiser {
+public:
+  /**
+   * State type.
+   */
+  typedef ParallelNelderMeadOptimiserState state_type;
+
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param filter Filter.
+   * @param mode Mode of operation.
+   * @param nstarts Total number of starts, over all processes.
+   * @param crn Use common random numbers?
+   */
+  ParallelNelderMeadOptimiser(B& m, F& filter, const OptimiserMode mode =
+      MAXIMUM_LIKELIHOOD, const int nstarts = 1, const bool crn = false);
+
+  /**
+   * @name High-level interface
+   *
+   * An easier interface for common usage.
+   */
+  //@{
+  /**
+   * Optimise.
+   *
+   * @tparam S ParallelOptimiserState type.
+   * @tparam IO1 Output type.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   * @param out Output buffer.
+   * @param inInit Initialisation file.
+   * @param simplexSizeRel Size of simplex relative to each dimension.
+   * @param stopSteps Maximum number of steps to take.
+   * @param stopSize Size for stopping criterion.
+   */
+  template<class S, class IO1, class IO2>
+  void optimise(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S& s, IO1& out, IO2& inInit,
+      const real simplexSizeRel = 0.1, const int stopSteps = 100,
+      const real stopSize = 1.0e-4);
+  //@}
+
+  /**
+   * @name Low-level interface
+   *
+   * Largely used by other features of the library or for finer control over
+   * performance and behaviour.
+   */
+  //@{
+  /**
+   * Initialise.
+   *
+   * @tparam S ParallelOptimiserState type.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   * @param inInit Initialisation file.
+   * @param simplexSizeRel Size of simplex relative to each dimension.
+   */
+  template<class S, class IO2>
+  void init(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S& s, IO2& inInit,
+      const real simplexSizeRel = 0.1);
+
+  /**
+   * Perform one iteration step of optimiser, for all starts that have not
+   * converged.
+   *
+   * @tparam S ParallelOptimiserState type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   * @param stopSize Size for stopping criterion.
+   */
+  template<class S>
+  void step(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S& s, const real stopSize = 1.0e-4);
+
+  /**
+   * Have all starts converged? Under MPI, all starts of all processes.
+   *
+   * @param stopSize Size for stopping criterion.
+   */
+  bool hasConverged(const real stopSize = 1.0e-4);
+
+  /**
+   * Output best vertex over all starts. Under MPI, this is the best vertex
+   * over the starts of all processes, so that all processes output the
+   * same.
+   *
+   * @tparam S ParallelOptimiserState type.
+   * @tparam IO1 Output type.
+   *
+   * @param k Index in output file.
+   * @param s State.
+   * @param[in,out] out Output buffer.
+   */
+  template<class S, class IO1>
+  void output(const int k, S& s, IO1& out);
+
+  /**
+   * Report progress on stderr.
+   *
+   * @param k Number of steps taken.
+   */
+  void report(const int k);
+
+  /**
+   * Terminate.
+   */
+  void term();
+  //@}
+
+private:
+  /**
+   * Evaluate the cost function at rows of a matrix, concurrently.
+   *
+   * @tparam S ParallelOptimiserState type.
+   * @tparam M1 Matrix type.
+   * @tparam V1 Vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   * @param X Points, one per row.
+   * @param[out] f Costs.
+   */
+  template<class S, class M1, class V1>
+  void evaluate(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S& s, const M1 X, V1 f);
+
+  /**
+   * Evaluate the cost function at a single point.
+   *
+   * @tparam S1 Filter state type.
+   * @tparam IO1 Filter output type.
+   * @tparam V1 Vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s Filter state.
+   * @param[in,out] out Filter output.
+   * @param x Point.
+   *
+   * @return Negative log-likelihood or log-posterior, or infinity if
+   * evaluation fails.
+   */
+  template<class S1, class IO1, class V1>
+  real cost(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, IO1& out, const V1 x);
+
+  /**
+   * Sort the vertices of a simplex by increasing cost, and update its size.
+   *
+   * @param k Start index.
+   */
+  void sort(const int k);
+
+  /**
+   * Model.
+   */
+  B& m;
+
+  /**
+   * Filter.
+   */
+  F& filter;
+
+  /**
+   * Optimisation mode.
+   */
+  OptimiserMode mode;
+
+  /**
+   * Use common random numbers?
+   */
+  bool crn;
+
+  /**
+   * Random number generator for filter when using common random numbers.
+   */
+  Random rngFilter;
+
+  /**
+   * Number of parameters.
+   */
+  int N;
+
+  /**
+   * Number of starts for this process.
+   */
+  int K;
+
+  /**
+   * Current state.
+   */
+  ParallelNelderMeadOptimiserState state;
+
+  /**
+   * Null initialisation buffer, for starts drawn from the prior.
+   */
+  InputNullBuffer inNull;
+};
+
+/**
+ * Factory for creating ParallelNelderMeadOptimiser objects.
+ *
+ * @ingroup method
+ *
+ * @tparam CL Cache location.
+ *
+ * @see ParallelNelderMeadOptimiser
+ */
+template<Location CL = ON_HOST>
+struct ParallelNelderMeadOptimiserFactory {
+  /**
+   * Create parallel Nelder-Mead optimiser.
+   *
+   * @return ParallelNelderMeadOptimiser object. Caller has ownership.
+   *
+   * @see ParallelNelderMeadOptimiser::ParallelNelderMeadOptimiser()
+   */
+  template<class B, class F>
+  static ParallelNelderMeadOptimiser<B,F>* create(B& m, F& filter,
+      const OptimiserMode mode = MAXIMUM_LIKELIHOOD, const int nstarts = 1,
+      const bool crn = false) {
+    return new ParallelNelderMeadOptimiser<B,F>(m, filter, mode, nstarts,
+        crn);
+  }
+};
+}
+
+#include "../math/misc.hpp"
+#include "../math/view.hpp"
+#include "../math/constant.hpp"
+#include "../math/function.hpp"
+#include "../math/operation.hpp"
+#include "../math/temp_vector.hpp"
+#include "../math/temp_matrix.hpp"
+#include "../primitive/matrix_primitive.hpp"
+#include "../misc/exception.hpp"
+#include "../misc/omp.hpp"
+#include "../misc/TicToc.hpp"
+#include "../mpi/mpi.hpp"
+
+#ifdef ENABLE_MPI
+#include "boost/serialization/utility.hpp"
+#endif
+
+#include <vector>
+#include <iostream>
+#include <limits>
+#include <functional>
+
+template<class B, class F>
+bi::ParallelNelderMeadOptimiser<B,F>::ParallelNelderMeadOptimiser(B& m,
+    F& filter, const OptimiserMode mode, const int nstarts, const bool crn) :
+    m(m), filter(filter), mode(mode), crn(crn), N(B::NP), K(
+        (nstarts - mpi_rank() + mpi_size() - 1)/mpi_size()), state(B::NP,
+        (nstarts - mpi_rank() + mpi_size() - 1)/mpi_size()), inNull(m) {
+  /* pre-condition */
+  BI_ERROR_MSG(nstarts >= mpi_size(),
+      "Number of starts must be at least the number of processes");
+}
+
+template<class B, class F>
+template<class S, class IO1, class IO2>
+void bi::ParallelNelderMeadOptimiser<B,F>::optimise(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S& s,
+    IO1& out, IO2& inInit, const real simplexSizeRel, const int stopSteps,
+    const real stopSize) {
+  TicToc clock;
+  int k = 0;
+  init(rng, first, last, s, inInit, simplexSizeRel);
+  while (k < stopSteps && !hasConverged(stopSize)) {
+    step(rng, first, last, s, stopSize);
+    report(k);
+    output(k, s, out);
+    ++k;
+  }
+  s.clock = clock.toc();
+  out.writeClock(s.clock);
+  term();
+}
+
+template<class B, class F>
+template<class S, class IO2>
+void bi::ParallelNelderMeadOptimiser<B,F>::init(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S& s,
+    IO2& inInit, const real simplexSizeRel) {
+  typename temp_host_vector<real>::type x(N);
+  int k, i, j;
+
+  /* common random numbers */
+  if (crn) {
+    rngFilter.seeds(rng.uniformInt(0, std::numeric_limits<int>::max()));
+  }
+
+  /* starting points, the first from the init file on the first process,
+   * others from the prior; read serially, as input buffers are not safe
+   * for concurrent use */
+  for (k = 0; k < K; ++k) {
+    if (k == 0 && mpi_rank() == 0) {
+      filter.init(rng, *first, s.s, s.out, inInit);
+    } else {
+      filter.init(rng, *first, s.s, s.out, inNull);
+    }
+    x = row(s.s.get(P_VAR), 0);
+
+    /* initial simplex */
+    for (i = 0; i <= N; ++i) {
+      row(state.X, k*(N + 1) + i) = x;
+    }
+    for (j = 0; j < N; ++j) {
+      state.X(k*(N + 1) + j + 1, j) += (x(j) != 0.0) ?
+          simplexSizeRel*bi::abs(x(j)) : simplexSizeRel;
+    }
+  }
+
+  /* evaluate the first vertex alone, so that forcer and observer caches are
+   * populated before concurrent evaluations */
+  evaluate(rng, first, last, s, rows(state.X, 0, 1), subrange(state.f, 0, 1));
+  evaluate(rng, first, last, s, rows(state.X, 1, K*(N + 1) - 1),
+      subrange(state.f, 1, K*(N + 1) - 1));
+  for (k = 0; k < K; ++k) {
+    sort(k);
+  }
+}
+
+template<class B, class F>
+template<class S>
+void bi::ParallelNelderMeadOptimiser<B,F>::step(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S& s,
+    const real stopSize) {
+  /* coefficients of reflection, expansion, contraction and shrink */
+  static const real alpha = 1.0, gamma = 2.0, rho = 0.5, sigma = 0.5;
+
+  typename temp_host_vector<real>::type xo(N), d(N);
+  std::vector<int> active, shrinks;
+  int k, i, a, n;
+
+  /* candidate points for each active start, along the line from the worst
+   * vertex through the centroid of the others */
+  for (k = 0; k < K; ++k) {
+    if (state.size(k) >= stopSize) {
+      active.push_back(k);
+    }
+  }
+  for (a = 0; a < (int)active.size(); ++a) {
+    k = active[a];
+    BOOST_AUTO(X, rows(state.X, k*(N + 1), N + 1));
+    sum_rows(rows(X, 0, N), xo);
+    scal(1.0/N, xo);
+    d = xo;
+    axpy(-1.0, row(X, N), d);
+
+    row(state.C, 4*a) = xo;
+    axpy(alpha, d, row(state.C, 4*a));
+    row(state.C, 4*a + 1) = xo;
+    axpy(alpha*gamma, d, row(state.C, 4*a + 1));
+    row(state.C, 4*a + 2) = xo;
+    axpy(alpha*rho, d, row(state.C, 4*a + 2));
+    row(state.C, 4*a + 3) = xo;
+    axpy(-rho, d, row(state.C, 4*a + 3));
+  }
+  n = 4*active.size();
+  evaluate(rng, first, last, s, rows(state.C, 0, n),
+      subrange(state.fc, 0, n));
+
+  /* accept one candidate per start, or shrink */
+  for (a = 0; a < (int)active.size(); ++a) {
+    k = active[a];
+    BOOST_AUTO(X, rows(state.X, k*(N + 1), N + 1));
+    BOOST_AUTO(f, subrange(state.f, k*(N + 1), N + 1));
+    const real fr = state.fc(4*a), fe = state.fc(4*a + 1),
+        foc = state.fc(4*a + 2), fic = state.fc(4*a + 3);
+    int c = -1;
+
+    if (fr < f(0)) {
+      c = (fe < fr) ? 4*a + 1 : 4*a;
+    } else if (fr < f(N - 1)) {
+      c = 4*a;
+    } else if (fr < f(N)) {
+      c = (foc <= fr) ? 4*a + 2 : -1;
+    } else {
+      c = (fic < f(N)) ? 4*a + 3 : -1;
+    }
+
+    if (c >= 0) {
+      row(X, N) = row(state.C, c);
+      f(N) = state.fc(c);
+    } else {
+      shrinks.push_back(k);
+    }
+  }
+
+  /* shrink toward best vertex */
+  if (shrinks.size() > 0) {
+    for (a = 0; a < (int)shrinks.size(); ++a) {
+      k = shrinks[a];
+      BOOST_AUTO(X, rows(state.X, k*(N + 1), N + 1));
+      for (i = 1; i <= N; ++i) {
+        BOOST_AUTO(c, row(state.C, a*N + i - 1));
+        c = row(X, i);
+        scal(sigma, c);
+        axpy(1.0 - sigma, row(X, 0), c);
+        row(X, i) = c;
+      }
+    }
+    n = N*shrinks.size();
+    evaluate(rng, first, last, s, rows(state.C, 0, n),
+        subrange(state.fc, 0, n));
+    for (a = 0; a < (int)shrinks.size(); ++a) {
+      k = shrinks[a];
+      subrange(state.f, k*(N + 1) + 1, N) = subrange(state.fc, a*N, N);
+    }
+  }
+
+  for (a = 0; a < (int)active.size(); ++a) {
+    sort(active[a]);
+  }
+}
+
+template<class B, class F>
+bool bi::ParallelNelderMeadOptimiser<B,F>::hasConverged(const real stopSize) {
+  bool converged = true;
+  for (int k = 0; k < K && converged; ++k) {
+    converged = state.size(k) < stopSize;
+  }
+
+  #ifdef ENABLE_MPI
+  /* all processes step together, as output() is collective */
+  boost::mpi::communicator world;
+  converged = boost::mpi::all_reduce(world, converged,
+      std::logical_and<bool>());
+  #endif
+
+  return converged;
+}
+
+template<class B, class F>
+template<class S, class IO1>
+void bi::ParallelNelderMeadOptimiser<B,F>::output(const int k, S& s,
+    IO1& out) {
+  const int b = state.best;
+  typename temp_host_vector<real>::type x(N);
+  real value = -state.f(b*(N + 1));
+  real size = state.size(b);
+
+  x = row(state.X, b*(N + 1));
+
+  #ifdef ENABLE_MPI
+  /* broadcast the best vertex from the process that holds it */
+  boost::mpi::communicator world;
+  std::pair<real,int> local(value, world.rank());
+  std::pair<real,int> global;
+
+  boost::mpi::all_reduce(world, local, global,
+      boost::mpi::maximum<std::pair<real,int> >());
+  boost::mpi::broadcast(world, x.buf(), N, global.second);
+  boost::mpi::broadcast(world, size, global.second);
+  value = global.first;
+  #endif
+
+  row(s.s.get(P_VAR), 0) = x;
+  out.writeParameters(k, s.s.get(P_VAR));
+  out.writeValue(k, value);
+  out.writeSize(k, size);
+}
+
+template<class B, class F>
+void bi::ParallelNelderMeadOptimiser<B,F>::report(const int k) {
+  const int b = state.best;
+
+  std::cerr << k << ":\t";
+  std::cerr << "value=" << -state.f(b*(N + 1));
+  std::cerr << '\t';
+  std::cerr << "size=" << state.size(b);
+  std::cerr << '\t';
+  std::cerr << "start=" << b;
+  std::cerr << std::endl;
+}
+
+template<class B, class F>
+void bi::ParallelNelderMeadOptimiser<B,F>::term() {
+  #ifdef ENABLE_MPI
+  boost::mpi::communicator world;
+  std::pair<real,int> local(-state.f(state.best*(N + 1)), world.rank());
+  std::pair<real,int> global;
+
+  boost::mpi::all_reduce(world, local, global,
+      boost::mpi::maximum<std::pair<real,int> >());
+  if (world.rank() == 0) {
+    std::cerr << "best value=" << global.first << " rank=" << global.second
+        << std::endl;
+  }
+  #endif
+}
+
+template<class B, class F>
+template<class S, class M1, class V1>
+void bi::ParallelNelderMeadOptimiser<B,F>::evaluate(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S& s,
+    const M1 X, V1 f) {
+  /* pre-condition */
+  BI_ASSERT(X.size1() == f.size());
+
+  /* filter runs vary in length, so dynamic scheduling */
+  #pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < (int)f.size(); ++i) {
+    f(i) = cost(rng, first, last, *s.s2s[bi_omp_tid], *s.out2s[bi_omp_tid],
+        row(X, i));
+  }
+}
+
+template<class B, class F>
+template<class S1, class IO1, class V1>
+real bi::ParallelNelderMeadOptimiser<B,F>::cost(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    IO1& out, const V1 x) {
+  Random& rng1 = crn ? rngFilter : rng;
+  real lp = 0.0;
+
+  if (crn) {
+    rngFilter.resetCommon();
+  }
+  filter.init(rng1, *first, s, out, inNull);
+  row(s.get(P_VAR), 0) = x;
+  s.get(PY_VAR) = s.get(P_VAR);
+  s.logPrior = m.parameterLogDensity(s);
+  m.initialSamples(rng1, s);
+
+  if (mode == MAXIMUM_A_POSTERIORI) {
+    lp = s.logPrior;
+  }
+  if (!bi::is_finite(lp)) {
+    return BI_INF;
+  }
+  try {
+    filter.filter(rng1, first, last, s, out);
+  } catch (CholeskyException e) {
+    return BI_INF;
+  } catch (ParticleFilterDegeneratedException e) {
+    return BI_INF;
+  }
+  if (!bi::is_finite(s.logLikelihood)) {
+    return BI_INF;
+  }
+  return -(s.logLikelihood + lp);
+}
+
+template<class B, class F>
+void bi::ParallelNelderMeadOptimiser<B,F>::sort(const int k) {
+  BOOST_AUTO(X, rows(state.X, k*(N + 1), N + 1));
+  BOOST_AUTO(f, subrange(state.f, k*(N + 1), N + 1));
+  typename temp_host_matrix<real>::type X1(N + 1, N);
+  typename temp_host_vector<real>::type f1(N + 1), c(N), d(N);
+  std::vector<std::pair<real,int> > order(N + 1);
+  real size = 0.0;
+  int i;
+
+  /* sort vertices by cost */
+  for (i = 0; i <= N; ++i) {
+    order[i] = std::make_pair(f(i), i);
+  }
+  std::stable_sort(order.begin(), order.end());
+  for (i = 0; i <= N; ++i) {
+    row(X1, i) = row(X, order[i].second);
+    f1(i) = order[i].first;
+  }
+  X = X1;
+  f = f1;
+
+  /* size, as mean distance of vertices from centroid */
+  sum_rows(X, c);
+  scal(1.0/(N + 1), c);
+  for (i = 0; i <= N; ++i) {
+    d = row(X, i);
+    axpy(-1.0, c, d);
+    size += bi::sqrt(dot(d, d));
+  }
+  state.size(k) = size/(N + 1);
+
+  /* best start */
+  if (f(0) < state.f(state.best*(N + 1))) {
+    state.best = k;
+  }
+}
+
+#endif
@@ -100,6 +100,18 @@ struct abs_functor : public std::unary_function<T,T> {
   }
 };
 
+/**
+ * @ingroup primitive_functor
+ *
+ * Minus one if input is negative, one if it is not.
+ */
+template<typename T>
+struct sign_functor : public std::unary_function<T,T> {
+  CUDA_FUNC_BOTH T operator()(const T &x) const {
+    return (x < static_cast<T>(0)) ? -1 : 1;
+  }
+};
+
 /**
  * @ingroup primitive_functor
  *
@@ -235,6 +235,32 @@ void sum_columns(const M1 X, V1 y);
 template<class M1, class V1>
 void sum_rows(const M1 X, V1 y);
 
+/**
+ * Clear matrix by rows.
+ *
+ * @ingroup primitive_matrix
+ *
+ * @tparam M1 Matrix type.
+ *
+ * @param[out] X Matrix.
+ *
+ * Sets all elements of @p X to zero. On host, rows are partitioned between
+ * threads in the same way as the per-particle loops of updaters, so that
+ * freshly allocated memory is first touched, and so placed on the memory
+ * node of, the thread that will subsequently update it.
+ */
+template<class M1>
+void clear_rows(M1 X);
+
+/**
+ * @internal
+ */
+template<Location L>
+struct clear_rows_impl {
+  template<class M1>
+  void func(M1 X);
+};
+
 /**
  * Gather rows of matrix.
  *
@@ -626,6 +652,11 @@ void bi::sum_rows(const M1 X, V1 y) {
   reduce_by_key(keys.begin(), keys.end(), X.begin(), discard, y.begin());
 }
 
+template<class M1>
+void bi::clear_rows(M1 X) {
+  clear_rows_impl<M1::location>::func(X);
+}
+
 template<class V1, class M1, class M2>
 void bi::gather_rows(const V1 map, const M1 X, M2 Y) {
   /* pre-conditions */
@@ -9,11 +9,11 @@
 #include "../cuda/device.hpp"
 #endif
 
-bi::Random::Random() : own(true) {
+bi::Random::Random() : own(true), lastSeed(0) {
   hostRngs = new RngHost[bi_omp_max_threads];
 }
 
-bi::Random::Random(const unsigned seed) : own(true) {
+bi::Random::Random(const unsigned seed) : own(true), lastSeed(seed) {
   hostRngs = new RngHost[bi_omp_max_threads];
   this->seeds(seed);
 }
@@ -24,6 +24,7 @@ bi::Random::Random(const Random& o) {
   devRngs = o.devRngs;
   #endif
   own = false;
+  lastSeed = o.lastSeed;
 }
 
 bi::Random::~Random() {
@@ -33,8 +34,17 @@ bi::Random::~Random() {
 }
 
 void bi::Random::seeds(const unsigned seed) {
+  lastSeed = seed;
   RandomHost::seeds(*this, seed);
   #ifdef ENABLE_CUDA
   RandomGPU::seeds(*this, seed);
   #endif
 }
+
+void bi::Random::reset() {
+  seeds(lastSeed);
+}
+
+void bi::Random::resetCommon() {
+  RandomHost::resetCommon(*this, lastSeed);
+}
@@ -11,6 +11,8 @@
 #include "../misc/location.hpp"
 #include "../cuda/cuda.hpp"
 
+#include "boost/serialization/split_member.hpp"
+
 #ifdef ENABLE_CUDA
 #include "../cuda/random/curandStateSA.hpp"
 #endif
@@ -164,6 +166,29 @@ public:
    */
   void seeds(const unsigned seed);
 
+  /**
+   * Reset all random number generators to the start of the streams given by
+   * the last call to seeds(), so that the same random numbers are drawn
+   * again.
+   *
+   * Used for common random numbers, where a computation is repeated with
+   * different inputs but the same randomness. With static scheduling, each
+   * thread draws the same numbers for the same items of work on each
+   * repetition.
+   */
+  void reset();
+
+  /**
+   * Reset the random number generator of the calling thread only, to the
+   * start of the stream of the first thread given by the last call to
+   * seeds().
+   *
+   * Used for common random numbers where single-threaded computations run
+   * concurrently, one per thread, so that each draws the same random
+   * numbers whichever thread it runs on. Device generators are not reset.
+   */
+  void resetCommon();
+
   /**
    * Generate random numbers from a multinomial distribution with given
    * probabilities.
@@ -276,6 +301,31 @@ public:
    * launch, the random number generators are not destroyed on exit.
    */
   bool own;
+
+  /**
+   * Seed given to the last call to seeds().
+   */
+  unsigned lastSeed;
+
+private:
+  /**
+   * Serialize. Only the random number generators on host are serialized.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization. The number of threads must match that at
+   * serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
 };
 }
 
@@ -377,4 +427,26 @@ inline bi::RngHost& bi::Random::getHostRng() {
 //}
 #endif
 
+template<class Archive>
+void bi::Random::save(Archive& ar, const unsigned version) const {
+  int n = bi_omp_max_threads;
+  ar & n;
+  for (int i = 0; i < n; ++i) {
+    ar & hostRngs[i];
+  }
+  ar & lastSeed;
+}
+
+template<class Archive>
+void bi::Random::load(Archive& ar, const unsigned version) {
+  int n;
+  ar & n;
+  BI_ERROR_MSG(n == bi_omp_max_threads,
+      "Random number generators saved for " << n << " threads, but running with " << bi_omp_max_threads);
+  for (int i = 0; i < n; ++i) {
+    ar & hostRngs[i];
+  }
+  ar & lastSeed;
+}
+
 #endif
@@ -0,0 +1,559 @@
+/**
+ * @file
+ *
+ * Rejection samplers for distributions whose parameters typically differ
+ * between draws, e.g. between particles.
+ *
+ * Each sampler separates setup, which depends only on the parameters, from
+ * the trials, and each trial into two parts: draw() takes the random numbers
+ * that the trial needs, and accept() decides upon them without further use
+ * of the random number generator. One setup then serves all trials of a
+ * variate, with no tables to build.
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_RANDOM_REJECTION_HPP
+#define BI_RANDOM_REJECTION_HPP
+
+#include "../cuda/cuda.hpp"
+#include "../math/function.hpp"
+#include "../math/constant.hpp"
+#include "../misc/assert.hpp"
+
+namespace bi {
+/**
+ * Gamma rejection sampler of @ref Marsaglia2000 "Marsaglia & Tsang (2000)".
+ *
+ * @ingroup math_rng
+ *
+ * @tparam T1 Scalar type.
+ *
+ * For shape less than one, the sampler draws with shape increased by one,
+ * then scales the variate by \f$U^{1/\alpha}\f$.
+ */
+template<class T1>
+struct gamma_rejection {
+  typedef T1 value_type;
+
+  /**
+   * Set up.
+   *
+   * @param alpha Shape.
+   * @param beta Scale.
+   */
+  CUDA_FUNC_BOTH void init(const T1 alpha, const T1 beta);
+
+  /**
+   * Draw random numbers for a trial.
+   */
+  template<class R>
+  CUDA_FUNC_BOTH void draw(R& rng);
+
+  /**
+   * Accept or reject the trial.
+   *
+   * @param[out] x The variate, if accepted.
+   *
+   * @return True if accepted, false otherwise.
+   */
+  CUDA_FUNC_BOTH bool accept(T1& x) const;
+
+  /*
+   * Setup.
+   */
+  T1 alpha, beta, d, c;
+
+  /*
+   * Trial.
+   */
+  T1 z, u, w;
+};
+
+/**
+ * Poisson transformed rejection sampler with squeeze (PTRS) of
+ * @ref Hormann1993a "Hörmann (1993)".
+ *
+ * @ingroup math_rng
+ *
+ * @tparam T1 Scalar type.
+ *
+ * Valid for rate of at least 10, see poisson_inversion() otherwise.
+ */
+template<class T1>
+struct poisson_rejection {
+  typedef T1 value_type;
+
+  /**
+   * Set up.
+   *
+   * @param lambda Rate.
+   */
+  CUDA_FUNC_BOTH void init(const T1 lambda);
+
+  /**
+   * @copydoc gamma_rejection::draw()
+   */
+  template<class R>
+  CUDA_FUNC_BOTH void draw(R& rng);
+
+  /**
+   * @copydoc gamma_rejection::accept()
+   */
+  CUDA_FUNC_BOTH bool accept(T1& x) const;
+
+  /*
+   * Setup.
+   */
+  T1 lambda, loglambda, a, b, loginvalpha, vr;
+
+  /*
+   * Trial.
+   */
+  T1 u, v;
+};
+
+/**
+ * Binomial transformed rejection sampler with decomposition (BTRD) of
+ * @ref Hormann1993b "Hörmann (1993)".
+ *
+ * @ingroup math_rng
+ *
+ * @tparam T1 Scalar type.
+ *
+ * Valid for \f$n\min(p,1-p)\f$ of at least 10, see binomial_inversion()
+ * otherwise. The final acceptance test uses log-factorials directly, rather
+ * than the Stirling approximation of the original.
+ */
+template<class T1>
+struct binomial_rejection {
+  typedef T1 value_type;
+
+  /**
+   * Set up.
+   *
+   * @param n Number of trials.
+   * @param p Probability of success.
+   */
+  CUDA_FUNC_BOTH void init(const T1 n, const T1 p);
+
+  /**
+   * @copydoc gamma_rejection::draw()
+   */
+  template<class R>
+  CUDA_FUNC_BOTH void draw(R& rng);
+
+  /**
+   * @copydoc gamma_rejection::accept()
+   */
+  CUDA_FUNC_BOTH bool accept(T1& x) const;
+
+  /*
+   * Setup.
+   */
+  T1 n, logr, a, b, c, alpha, vr, m, logfm;
+  bool flip;
+
+  /*
+   * Trial.
+   */
+  T1 u, v;
+};
+
+/**
+ * Truncated Gaussian rejection sampler of
+ * @ref Robert1995 "Robert (1995)".
+ *
+ * @ingroup math_rng
+ *
+ * @tparam T1 Scalar type.
+ *
+ * After standardisation, and reflection so that the interval is not wholly
+ * negative, one of three proposals is used: the Gaussian itself, when the
+ * interval contains zero and is wide; a uniform over the interval, when it
+ * is narrow; otherwise a translated exponential with the optimal rate.
+ */
+template<class T1>
+struct truncated_gaussian_rejection {
+  typedef T1 value_type;
+
+  /**
+   * Set up.
+   *
+   * @param lower Lower bound, may be infinite.
+   * @param upper Upper bound, may be infinite.
+   * @param mu Mean.
+   * @param sigma Standard deviation.
+   */
+  CUDA_FUNC_BOTH void init(const T1 lower, const T1 upper, const T1 mu,
+      const T1 sigma);
+
+  /**
+   * @copydoc gamma_rejection::draw()
+   */
+  template<class R>
+  CUDA_FUNC_BOTH void draw(R& rng);
+
+  /**
+   * @copydoc gamma_rejection::accept()
+   */
+  CUDA_FUNC_BOTH bool accept(T1& x) const;
+
+  /**
+   * Proposals.
+   */
+  enum Proposal {
+    POINT, GAUSSIAN, UNIFORM, EXPONENTIAL
+  };
+
+  /*
+   * Setup.
+   */
+  T1 a, b, mu, sigma, lambda;
+  Proposal proposal;
+
+  /*
+   * Trial.
+   */
+  T1 u1, u2;
+};
+
+/**
+ * Sample variate by rejection.
+ *
+ * @tparam R Random number generator type.
+ * @tparam G Rejection sampler type.
+ *
+ * @param[in,out] rng Random number generator.
+ * @param g Rejection sampler, set up.
+ *
+ * @return The variate.
+ */
+template<class R, class G>
+CUDA_FUNC_BOTH typename G::value_type rejection_sample(R& rng, G& g);
+
+/**
+ * Generate a random number from a Poisson distribution by sequential
+ * inversion, for small rates.
+ *
+ * @tparam R Random number generator type.
+ * @tparam T1 Scalar type.
+ *
+ * @param[in,out] rng Random number generator.
+ * @param lambda Rate.
+ *
+ * @return The random number.
+ */
+template<class R, class T1>
+CUDA_FUNC_BOTH T1 poisson_inversion(R& rng, const T1 lambda);
+
+/**
+ * Generate a random number from a binomial distribution by sequential
+ * inversion, for small means.
+ *
+ * @tparam R Random number generator type.
+ * @tparam T1 Scalar type.
+ *
+ * @param[in,out] rng Random number generator.
+ * @param n Number of trials.
+ * @param p Probability of success.
+ *
+ * @return The random number.
+ */
+template<class R, class T1>
+CUDA_FUNC_BOTH T1 binomial_inversion(R& rng, const T1 n, const T1 p);
+}
+
+template<class T1>
+inline void bi::gamma_rejection<T1>::init(const T1 alpha, const T1 beta) {
+  /* pre-condition */
+  BI_ASSERT(alpha > static_cast<T1>(0.0));
+  BI_ASSERT(beta > static_cast<T1>(0.0));
+
+  this->alpha = alpha;
+  this->beta = beta;
+  if (alpha < static_cast<T1>(1.0)) {
+    d = alpha + static_cast<T1>(1.0 - 1.0/3.0);
+  } else {
+    d = alpha - static_cast<T1>(1.0/3.0);
+  }
+  c = static_cast<T1>(1.0)/bi::sqrt(static_cast<T1>(9.0)*d);
+}
+
+template<class T1>
+template<class R>
+inline void bi::gamma_rejection<T1>::draw(R& rng) {
+  const T1 zero = static_cast<T1>(0.0);
+  const T1 one = static_cast<T1>(1.0);
+
+  z = rng.gaussian(zero, one);
+  u = rng.uniform(zero, one);
+  if (alpha < one) {
+    w = rng.uniform(zero, one);
+  }
+}
+
+template<class T1>
+inline bool bi::gamma_rejection<T1>::accept(T1& x) const {
+  const T1 one = static_cast<T1>(1.0);
+
+  T1 v = one + c*z;
+  if (v <= static_cast<T1>(0.0)) {
+    return false;
+  }
+  v = v*v*v;
+  if (bi::log(u) < static_cast<T1>(0.5)*z*z + d - d*v + d*bi::log(v)) {
+    x = beta*d*v;
+    if (alpha < one) {
+      x *= bi::pow(w, one/alpha);
+    }
+    return true;
+  }
+  return false;
+}
+
+template<class T1>
+inline void bi::poisson_rejection<T1>::init(const T1 lambda) {
+  /* pre-condition */
+  BI_ASSERT(lambda >= static_cast<T1>(10.0));
+
+  this->lambda = lambda;
+  loglambda = bi::log(lambda);
+  b = static_cast<T1>(0.931) + static_cast<T1>(2.53)*bi::sqrt(lambda);
+  a = static_cast<T1>(-0.059) + static_cast<T1>(0.02483)*b;
+  loginvalpha = bi::log(static_cast<T1>(1.1239) +
+      static_cast<T1>(1.1328)/(b - static_cast<T1>(3.4)));
+  vr = static_cast<T1>(0.9277) - static_cast<T1>(3.6224)/(b -
+      static_cast<T1>(2.0));
+}
+
+template<class T1>
+template<class R>
+inline void bi::poisson_rejection<T1>::draw(R& rng) {
+  const T1 zero = static_cast<T1>(0.0);
+  const T1 one = static_cast<T1>(1.0);
+
+  u = rng.uniform(zero, one) - static_cast<T1>(0.5);
+  v = rng.uniform(zero, one);
+}
+
+template<class T1>
+inline bool bi::poisson_rejection<T1>::accept(T1& x) const {
+  const T1 us = static_cast<T1>(0.5) - bi::abs(u);
+  const T1 k = bi::floor((static_cast<T1>(2.0)*a/us + b)*u + lambda +
+      static_cast<T1>(0.43));
+
+  if (us >= static_cast<T1>(0.07) && v <= vr) {
+    x = k;
+    return true;
+  }
+  if (k < static_cast<T1>(0.0) || (us < static_cast<T1>(0.013) && v > us)) {
+    return false;
+  }
+  if (bi::log(v) + loginvalpha - bi::log(a/(us*us) + b) <= -lambda +
+      k*loglambda - bi::lgamma(k + static_cast<T1>(1.0))) {
+    x = k;
+    return true;
+  }
+  return false;
+}
+
+template<class T1>
+inline void bi::binomial_rejection<T1>::init(const T1 n, const T1 p) {
+  const T1 one = static_cast<T1>(1.0);
+
+  flip = p > static_cast<T1>(0.5);
+  const T1 p1 = flip ? one - p : p;
+  const T1 spq = bi::sqrt(n*p1*(one - p1));
+
+  /* pre-condition */
+  BI_ASSERT(n*p1 >= static_cast<T1>(10.0));
+
+  this->n = n;
+  logr = bi::log(p1/(one - p1));
+  b = static_cast<T1>(1.15) + static_cast<T1>(2.53)*spq;
+  a = static_cast<T1>(-0.0873) + static_cast<T1>(0.0248)*b +
+      static_cast<T1>(0.01)*p1;
+  c = n*p1 + static_cast<T1>(0.5);
+  alpha = (static_cast<T1>(2.83) + static_cast<T1>(5.1)/b)*spq;
+  vr = static_cast<T1>(0.92) - static_cast<T1>(4.2)/b;
+  m = bi::floor((n + one)*p1);
+  logfm = bi::lgamma(m + one) + bi::lgamma(n - m + one);
+}
+
+template<class T1>
+template<class R>
+inline void bi::binomial_rejection<T1>::draw(R& rng) {
+  const T1 zero = static_cast<T1>(0.0);
+  const T1 one = static_cast<T1>(1.0);
+
+  u = rng.uniform(zero, one) - static_cast<T1>(0.5);
+  v = rng.uniform(zero, one);
+}
+
+template<class T1>
+inline bool bi::binomial_rejection<T1>::accept(T1& x) const {
+  const T1 one = static_cast<T1>(1.0);
+  const T1 us = static_cast<T1>(0.5) - bi::abs(u);
+  const T1 k = bi::floor((static_cast<T1>(2.0)*a/us + b)*u + c);
+
+  if (k < static_cast<T1>(0.0) || k > n) {
+    return false;
+  }
+  bool accepted = us >= static_cast<T1>(0.07) && v <= vr;
+  if (!accepted) {
+    const T1 logv = bi::log(v*alpha/(a/(us*us) + b));
+    accepted = logv <= logfm - bi::lgamma(k + one) -
+        bi::lgamma(n - k + one) + (k - m)*logr;
+  }
+  if (accepted) {
+    x = flip ? n - k : k;
+  }
+  return accepted;
+}
+
+template<class T1>
+inline void bi::truncated_gaussian_rejection<T1>::init(const T1 lower,
+    const T1 upper, const T1 mu, const T1 sigma) {
+  /* pre-condition */
+  BI_ASSERT(upper >= lower);
+  BI_ASSERT(sigma > static_cast<T1>(0.0) ||
+      (sigma == static_cast<T1>(0.0) && lower <= mu && mu <= upper));
+
+  const T1 zero = static_cast<T1>(0.0);
+
+  this->mu = mu;
+  this->sigma = sigma;
+  if (sigma == zero) {
+    proposal = POINT;
+  } else {
+    a = (lower - mu)/sigma;
+    b = (upper - mu)/sigma;
+    if (b <= zero) {
+      /* reflect */
+      T1 tmp = a;
+      a = -b;
+      b = -tmp;
+      this->sigma = -sigma;
+    }
+
+    if (a < zero) {
+      /* interval contains zero */
+      if (b - a < static_cast<T1>(BI_SQRT_TWO_PI)) {
+        proposal = UNIFORM;
+      } else {
+        proposal = GAUSSIAN;
+      }
+    } else {
+      const T1 s = bi::sqrt(a*a + static_cast<T1>(4.0));
+      lambda = static_cast<T1>(0.5)*(a + s);
+      if (b - a <= static_cast<T1>(2.0)/(a + s)*bi::exp(static_cast<T1>(0.25)*
+          (a*a - a*s) + static_cast<T1>(0.5))) {
+        proposal = UNIFORM;
+      } else {
+        proposal = EXPONENTIAL;
+      }
+    }
+  }
+}
+
+template<class T1>
+template<class R>
+inline void bi::truncated_gaussian_rejection<T1>::draw(R& rng) {
+  const T1 zero = static_cast<T1>(0.0);
+  const T1 one = static_cast<T1>(1.0);
+
+  if (proposal == GAUSSIAN) {
+    u1 = rng.gaussian(zero, one);
+  } else if (proposal != POINT) {
+    u1 = rng.uniform(zero, one);
+    u2 = rng.uniform(zero, one);
+  }
+}
+
+template<class T1>
+inline bool bi::truncated_gaussian_rejection<T1>::accept(T1& x) const {
+  const T1 zero = static_cast<T1>(0.0);
+  const T1 one = static_cast<T1>(1.0);
+  const T1 half = static_cast<T1>(0.5);
+
+  T1 y;
+  bool accepted;
+  switch (proposal) {
+  case GAUSSIAN:
+    y = u1;
+    accepted = a <= y && y <= b;
+    break;
+  case UNIFORM:
+    y = a + (b - a)*u1;
+    if (a < zero) {
+      accepted = u2 <= bi::exp(-half*y*y);
+    } else {
+      accepted = u2 <= bi::exp(half*(a*a - y*y));
+    }
+    break;
+  case EXPONENTIAL:
+    y = a - bi::log(one - u1)/lambda;
+    accepted = y <= b && u2 <= bi::exp(-half*(y - lambda)*(y - lambda));
+    break;
+  default:
+    y = zero;
+    accepted = true;
+  }
+  if (accepted) {
+    x = mu + sigma*y;
+  }
+  return accepted;
+}
+
+template<class R, class G>
+inline typename G::value_type bi::rejection_sample(R& rng, G& g) {
+  typename G::value_type x;
+  do {
+    g.draw(rng);
+  } while (!g.accept(x));
+  return x;
+}
+
+template<class R, class T1>
+inline T1 bi::poisson_inversion(R& rng, const T1 lambda) {
+  /* pre-condition */
+  BI_ASSERT(lambda >= static_cast<T1>(0.0));
+
+  const T1 zero = static_cast<T1>(0.0);
+  const T1 one = static_cast<T1>(1.0);
+
+  T1 x = zero, p = bi::exp(-lambda), u = rng.uniform(zero, one);
+  while (u > p && p > zero) {
+    u -= p;
+    x += one;
+    p *= lambda/x;
+  }
+  return x;
+}
+
+template<class R, class T1>
+inline T1 bi::binomial_inversion(R& rng, const T1 n, const T1 p) {
+  /* pre-condition */
+  BI_ASSERT(n >= static_cast<T1>(0.0));
+  BI_ASSERT(p >= static_cast<T1>(0.0) && p <= static_cast<T1>(1.0));
+
+  const T1 zero = static_cast<T1>(0.0);
+  const T1 one = static_cast<T1>(1.0);
+  const bool flip = p > static_cast<T1>(0.5);
+  const T1 p1 = flip ? one - p : p;
+
+  T1 x = zero;
+  if (p1 > zero) {
+    const T1 s = p1/(one - p1);
+    const T1 a = (n + one)*s;
+    T1 r = bi::pow(one - p1, n), u = rng.uniform(zero, one);
+    while (u > r && x < n) {
+      u -= r;
+      x += one;
+      r *= a/x - s;
+    }
+  }
+  return flip ? n - x : x;
+}
+
+#endif
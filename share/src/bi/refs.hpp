@@ -20,6 +20,11 @@
  * Bentley, J. L. & Saxe, J. B. Generating sorted lists of random numbers.
  * <i>Carnegie Mellon University</i>, <b>1979</b>.
  *
+ * @anchor Bishop2001
+ * Bishop, C. H.; Etherton, B. J. & Majumdar, S. J. Adaptive sampling with
+ * the ensemble transform Kalman filter. Part I: Theoretical aspects.
+ * <i>Monthly Weather Review</i>, <b>2001</b>, 129, 420-436.
+ *
  * @anchor Chopin2013
  * Chopin, N.; Jacob, P. & Papaspiliopoulos, O. SMC\f$^2\f$: An Efficient
  * Algorithm for Sequential Analysis of State Space Models. <i>Journal of the
@@ -29,6 +34,12 @@
  * Del Moral, P. & Murray L. M. Sequential Monte Carlo with highly informative
  * observations. <b>2014</b>. http://arxiv.org/abs/1405.4081.
  *
+ * @anchor Evensen1994
+ * Evensen, G. Sequential data assimilation with a nonlinear
+ * quasi-geostrophic model using Monte Carlo methods to forecast error
+ * statistics. <i>Journal of Geophysical Research</i>, <b>1994</b>, 99,
+ * 10143-10162.
+ *
  * @anchor Gray2001
  * Gray, A. G. & Moore, A. W. `N-Body' Problems in Statistical
  * Learning. <i>Advances in Neural Information Processing Systems</i>,
@@ -42,6 +53,21 @@
  * Hairer, E.; Norsett, S. N. & Wanner, G. Solving Ordinary Differential
  * Equations I: Nonstiff Problems. Springer-Verlag, <b>1993</b>.
  *
+ * @anchor Hormann1993a
+ * Hörmann, W. The transformed rejection method for generating Poisson
+ * random variables. <i>Insurance: Mathematics and Economics</i>,
+ * <b>1993</b>, 12, 39-45.
+ *
+ * @anchor Hormann1993b
+ * Hörmann, W. The generation of binomial random variates. <i>Journal of
+ * Statistical Computation and Simulation</i>, <b>1993</b>, 46, 101-110.
+ *
+ * @anchor Ionides2015
+ * Ionides, E. L.; Nguyen, D.; Atchad\'e, Y.; Stoev, S. & King, A. A.
+ * Inference for dynamic and latent variable models via iterated, perturbed
+ * Bayes maps. <i>Proceedings of the National Academy of Sciences</i>,
+ * <b>2015</b>, 112, 719-724.
+ *
  * @anchor Jones2010
  * Jones, E.; Parslow, J. & Murray, L. A Bayesian approach to state and
  * parameter estimation in a Phytoplankton-Zooplankton model. <i>Australian
@@ -86,6 +112,10 @@
  * Murray, L. M.; Lee, A & Jacob P. E. Parallel resampling in the particle
  * filter. <b>2014</b>. http://arxiv.org/abs/1301.4019.
  *
+ * @anchor Murray2016
+ * Murray, L. M.; Singh, S.; Jacob, P. E. & Lee, A. Anytime Monte Carlo.
+ * <b>2016</b>. http://arxiv.org/abs/1612.03319.
+ *
  * @anchor Pitt1999
  * Pitt, M. & Shephard, N. Filtering Via Simulation: Auxiliary Particle
  * Filters. <i>Journal of the American Statistical Association</i>,
@@ -101,6 +131,15 @@
  * filtering within adaptive Metropolis-Hastings sampling, <b>2010</b>.
  * http://arxiv.org/abs/1006.1914
  *
+ * @anchor Rebeschini2015
+ * Rebeschini, P. & van Handel, R. Can local particle filters beat the curse
+ * of dimensionality? <i>The Annals of Applied Probability</i>, <b>2015</b>,
+ * 25, 2809-2866.
+ *
+ * @anchor Robert1995
+ * Robert, C. P. Simulation of truncated normal variables. <i>Statistics and
+ * Computing</i>, <b>1995</b>, 5, 121-125.
+ *
  * @anchor Sarkka2008
  * Särkkä, S. Unscented Rauch-Tung-Striebel Smoother. <i>IEEE Transactions on
  * Automated Control</i>, <b>2008</b>, 53, 845-849.
@@ -108,4 +147,8 @@
  * @anchor Silverman1986
  * Silverman, B.W. <i>Density Estimation for Statistics and Data
  * Analysis</i>. Chapman and Hall, <b>1986</b>.
+ *
+ * @anchor Skilling2004
+ * Skilling, J. Programming the Hilbert curve. <i>AIP Conference
+ * Proceedings</i>, <b>2004</b>, 707, 381-387.
  */
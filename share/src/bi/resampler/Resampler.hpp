@@ -67,6 +67,26 @@ public:
    */
   void setMaxLogWeight(const double maxLogWeight);
 
+  /**
+   * Sort particles along a Hilbert curve before resampling?
+   */
+  bool getSort() const;
+
+  /**
+   * Set whether to sort particles along a Hilbert curve before resampling.
+   */
+  void setSort(const bool sort);
+
+  /**
+   * Get number of active particles eliminated in anytime mode.
+   */
+  int getNumEliminated() const;
+
+  /**
+   * Set number of active particles eliminated in anytime mode.
+   */
+  void setNumEliminated(const int neliminated);
+
   /**
    * Compute ESS and incremental log-likelihood.
    */
@@ -87,6 +107,29 @@ public:
   template<class S1>
   bool resample(Random& rng, const ScheduleElement now, S1& s);
 
+  /**
+   * Resample, after sorting particles along a Hilbert curve through their
+   * state.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param now Current step in time schedule.
+   * @param[in,out] s State.
+   *
+   * @return Was resampling performed?
+   *
+   * Ancestors are selected as though the particles were ordered by the
+   * Hilbert index of their state variables, so that the selection varies
+   * smoothly with the particles themselves. This preserves the correlation
+   * between successive likelihood estimates of correlated pseudo-marginal
+   * methods when the same random numbers are reused. Offspring are left in
+   * sorted order rather than permuted, so that the random numbers consumed
+   * by each particle do not depend on which particles die.
+   */
+  template<class S1>
+  bool resampleSorted(Random& rng, const ScheduleElement now, S1& s);
+
   /**
    * Randomly shuffle particles.
    *
@@ -114,17 +157,38 @@ protected:
    * Use anytime mode?
    */
   bool anytime;
+
+  /**
+   * Number of active particles eliminated in anytime mode.
+   */
+  int neliminated;
+
+  /**
+   * Sort particles before resampling?
+   */
+  bool sort;
+};
+
+/**
+ * @internal
+ */
+template<class R, Location L>
+struct precompute_type<Resampler<R>,L> {
+  typedef typename precompute_type<R,L>::type type;
 };
 }
 
 #include "../primitive/vector_primitive.hpp"
 #include "../primitive/matrix_primitive.hpp"
+#include "../math/temp_vector.hpp"
+#include "../math/temp_matrix.hpp"
 
 #include "boost/mpl/if.hpp"
 
 template<class R>
 inline bi::Resampler<R>::Resampler(const double essRel, const bool anytime) :
-    essRel(essRel), maxLogWeight(0.0), anytime(anytime) {
+    essRel(essRel), maxLogWeight(0.0), anytime(anytime), neliminated(
+        1), sort(false) {
   /* pre-condition */
   BI_ASSERT(essRel >= 0.0 && essRel <= 1.0);
 
@@ -151,13 +215,36 @@ void bi::Resampler<R>::setMaxLogWeight(const double maxLogWeight) {
   this->maxLogWeight = maxLogWeight;
 }
 
+template<class R>
+inline bool bi::Resampler<R>::getSort() const {
+  return sort;
+}
+
+template<class R>
+inline void bi::Resampler<R>::setSort(const bool sort) {
+  this->sort = sort;
+}
+
+template<class R>
+inline int bi::Resampler<R>::getNumEliminated() const {
+  return neliminated;
+}
+
+template<class R>
+inline void bi::Resampler<R>::setNumEliminated(const int neliminated) {
+  /* pre-condition */
+  BI_ASSERT(neliminated >= 0);
+
+  this->neliminated = neliminated;
+}
+
 template<class R>
 template<class V1>
 double bi::Resampler<R>::reduce(const V1 lws, double* lW) {
   double ess = ess_reduce(lws, lW);
   if (anytime) {
     const int P = lws.size();
-    *lW += bi::log(P / (P - 1.0));
+    *lW += bi::log(P / double(P - neliminated));
   }
   return ess;
 }
@@ -181,6 +268,47 @@ bool bi::Resampler<R>::resample(Random& rng, const ScheduleElement now, S1& s) {
   return r;
 }
 
+template<class R>
+template<class S1>
+bool bi::Resampler<R>::resampleSorted(Random& rng, const ScheduleElement now,
+    S1& s) {
+  bool r = (now.isObserved() || now.hasBridge()) && s.ess < essRel * s.size();
+  if (r) {
+    typedef unsigned long long key_type;
+
+    const int P = s.size();
+    typename precompute_type<R,ON_HOST>::type pre;
+    typename temp_host_matrix<real>::type X(P, s.get(D_VAR).size2());
+    typename temp_host_vector<real>::type lws(P), lws1(P);
+    typename temp_host_vector<key_type>::type keys(P);
+    typename temp_host_vector<int>::type ps(P), as1(P), as2(P);
+    typename S1::temp_int_vector_type as3(P);
+
+    /* sort */
+    X = s.get(D_VAR);
+    lws = s.logWeights();
+    hilbertKeys(X, keys);
+    seq_elements(ps, 0);
+    sort_by_key(keys, ps);
+    bi::gather(ps, lws, lws1);
+
+    /* select ancestors in sorted order and map back to original order; the
+     * offspring are not permuted, so that each slot, and so the random
+     * numbers it consumes, follows the sorted order regardless of which
+     * particles die, at the cost of an out-of-place copy */
+    R::precompute(lws1, pre);
+    R::ancestors(rng, lws1, as1, pre);
+    bi::gather(as1, ps, as2);
+    as3 = as2;
+
+    s.gather(now, as3, false);
+    set_elements(s.logWeights(), s.logLikelihood);
+  } else if (now.hasOutput()) {
+    seq_elements(s.ancestors(), 0);
+  }
+  return r;
+}
+
 template<class R>
 template<class S1>
 void bi::Resampler<R>::shuffle(Random& rng, S1& s) {
@@ -89,6 +89,30 @@ static void cumulativeOffspringToOffspring(const V1 Os, V2 os);
  */
 template<class V1>
 static void permute(V1 as);
+
+/**
+ * Compute Hilbert curve indices of points.
+ *
+ * @tparam M1 Matrix type.
+ * @tparam V1 Integral vector type.
+ *
+ * @param X Points, one per row.
+ * @param[out] keys Hilbert indices.
+ *
+ * Each column of @p X is rescaled to its range across rows and discretised
+ * to a grid, and the index of each row along the Hilbert curve through that
+ * grid computed (@ref Skilling2004 "Skilling, 2004"). Sorting on these keys
+ * gives an ordering of the rows in which nearby points tend to be adjacent.
+ * The number of bits per dimension is the bit width of the key type divided
+ * by the number of columns; any columns beyond the bit width are ignored.
+ *
+ * @section hilbertKeys_references References
+ *
+ * @anchor Skilling2004 Skilling, J. Programming the Hilbert curve.
+ * <i>AIP Conference Proceedings</i>, <b>2004</b>, 707, 381-387.
+ */
+template<class M1, class V1>
+static void hilbertKeys(const M1 X, V1 keys);
 }
 
 #include "../host/resampler/ResamplerHost.hpp"
@@ -96,6 +120,10 @@ static void permute(V1 as);
 #include "../cuda/resampler/ResamplerGPU.cuh"
 #endif
 #include "../primitive/vector_primitive.hpp"
+#include "../primitive/matrix_primitive.hpp"
+#include "../math/temp_vector.hpp"
+
+#include <vector>
 
 template<class V1, class V2>
 void bi::ancestorsToOffspring(const V1 as, V2 os) {
@@ -163,4 +191,91 @@ void bi::permute(const V1 as) {
   impl::permute(as);
 }
 
+template<class M1, class V1>
+void bi::hilbertKeys(const M1 X, V1 keys) {
+  /* pre-conditions */
+  BI_ASSERT(!M1::on_device);
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(X.size1() == keys.size());
+
+  typedef typename M1::value_type T1;
+  typedef typename V1::value_type T2;
+
+  const int nbits = 8*sizeof(T2);
+  const int N = bi::min(static_cast<int>(X.size2()), nbits);
+  const int P = X.size1();
+
+  if (N == 0) {
+    keys.clear();
+    return;
+  }
+
+  /* bits per dimension, and largest grid coordinate */
+  const int b = nbits/N;
+  const T2 M = static_cast<T2>(1) << (b - 1);
+  const T2 maxc = M + (M - 1);
+
+  typename temp_host_vector<T1>::type lo(N), hi(N);
+  int j;
+  for (j = 0; j < N; ++j) {
+    lo(j) = min_reduce(column(X, j));
+    hi(j) = max_reduce(column(X, j));
+  }
+
+  #pragma omp parallel
+  {
+    std::vector<T2> x(N);
+    T2 key, Q, t;
+    T1 u;
+    int p, i, k;
+
+    #pragma omp for schedule(static)
+    for (p = 0; p < P; ++p) {
+      /* grid coordinates */
+      for (i = 0; i < N; ++i) {
+        u = (hi(i) > lo(i)) ? (X(p, i) - lo(i))/(hi(i) - lo(i)) : 0.0;
+        x[i] = (u >= 1.0) ? maxc : static_cast<T2>(u*maxc);
+      }
+
+      if (N > 1) {
+        /* coordinates to transposed Hilbert index, inverse undo... */
+        for (Q = M; Q > 1; Q >>= 1) {
+          for (i = 0; i < N; ++i) {
+            if (x[i] & Q) {
+              x[0] ^= Q - 1;
+            } else {
+              t = (x[0] ^ x[i]) & (Q - 1);
+              x[0] ^= t;
+              x[i] ^= t;
+            }
+          }
+        }
+
+        /* ...then Gray encode */
+        for (i = 1; i < N; ++i) {
+          x[i] ^= x[i - 1];
+        }
+        t = 0;
+        for (Q = M; Q > 1; Q >>= 1) {
+          if (x[N - 1] & Q) {
+            t ^= Q - 1;
+          }
+        }
+        for (i = 0; i < N; ++i) {
+          x[i] ^= t;
+        }
+      }
+
+      /* interleave bits of transposed index */
+      key = 0;
+      for (k = b - 1; k >= 0; --k) {
+        for (i = 0; i < N; ++i) {
+          key = (key << 1) | ((x[i] >> k) & 1);
+        }
+      }
+      keys(p) = key;
+    }
+  }
+}
+
 #endif
@@ -0,0 +1,481 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_SAMPLER_ITERATEDFILTERING_HPP
+#define BI_SAMPLER_ITERATEDFILTERING_HPP
+
+#include "../state/Schedule.hpp"
+#include "../random/Random.hpp"
+#include "../misc/exception.hpp"
+#include "../misc/PhaseTimer.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * Iterated filtering.
+ *
+ * @ingroup method_sampler
+ *
+ * @tparam B Model type
+ * @tparam F Filter type.
+ *
+ * Implements the IF2 algorithm of
+ * @ref Ionides2015 "Ionides, Nguyen, Atchad\'e, Stoev \& King (2015)" for
+ * maximum likelihood estimation, with all iterations run in-process, so that
+ * the filter, its input and observation caches, and the state, are reused
+ * from one iteration to the next.
+ *
+ * The model must have been transformed by
+ * @c --with-transform-iterated-filtering. Each original parameter @c theta
+ * is then a state variable, perturbed by a Gaussian random walk with
+ * standard deviation @c sigma_ at each time step, and drawn initially from a
+ * Gaussian with mean @c theta_0_ + @c theta_c_ and standard deviation
+ * @c tau_, where @c theta_c_ is a state variable, zero by default. On the
+ * first iteration, the filter is run on this model as is. On each
+ * subsequent iteration, the swarm of parameter particles at the end of the
+ * previous iteration is resampled according to their final weights, and
+ * @c theta_c_ of each particle set so that its initial draw is centred on
+ * its member of the swarm. The initial draw then perturbs the swarm with
+ * standard deviation @c tau_, and the initial values of other state
+ * variables are drawn conditional on the perturbed parameters. Both
+ * @c tau_ and @c sigma_ are multiplied by a cooling factor after each
+ * iteration; their initial values are those of the parameter block or init
+ * file.
+ *
+ * After each iteration, each @c theta_0_ is set to the mean of the swarm,
+ * and all parameters are output as a sample, along with the log-likelihood
+ * estimate of the perturbed model, so that the output is a trace of the
+ * point estimate over iterations.
+ */
+template<class B, class F>
+class IteratedFiltering {
+public:
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param filter Filter.
+   * @param cooling Cooling factor, in \f$(0,1]\f$. The standard deviations
+   * of perturbations are multiplied by this after each iteration.
+   */
+  IteratedFiltering(B& m, F& filter, const double cooling = 0.95);
+
+  /**
+   * @name High-level interface
+   *
+   * An easier interface for common usage.
+   */
+  //@{
+  /**
+   * Sample.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param s State.
+   * @param C Number of iterations.
+   * @param out Output buffer.
+   * @param inInit Initialisation file.
+   */
+  template<class S1, class IO1, class IO2>
+  void sample(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, const int C, IO1& out, IO2& inInit);
+  //@}
+
+  /**
+   * @name Low-level interface
+   *
+   * Largely used by other features of the library or for finer control over
+   * performance and behaviour.
+   */
+  //@{
+  /**
+   * Initialise, and run the first iteration.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[out] s1 State.
+   * @param[in,out] out Output buffer of filter.
+   * @param inInit Initialisation file.
+   */
+  template<class S1, class IO1, class IO2>
+  void init(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s1, IO1& out, IO2& inInit);
+
+  /**
+   * Run one further iteration.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s1 State.
+   * @param[in,out] out Output buffer of filter.
+   */
+  template<class S1, class IO1>
+  void step(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s1, IO1& out);
+
+  /**
+   * Output.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param c Index in output file.
+   * @param s1 State.
+   * @param[in,out] out Output buffer.
+   */
+  template<class S1, class IO1>
+  void output(const int c, const S1& s1, IO1& out);
+
+  /**
+   * @copydoc Simulator::outputT()
+   */
+  template<class S1, class IO1>
+  void outputT(const S1& s, IO1& out);
+
+  /**
+   * Report progress on stderr.
+   *
+   * @tparam S1 State type.
+   *
+   * @param c Number of iterations taken.
+   * @param s1 State.
+   *
+   * If timing is enabled (PhaseTimer::setEnabled()), the progress line is
+   * followed by a line beginning @c timing, giving the execution
+   * time of the iteration by phase, as @c name=microseconds pairs
+   * (see PhaseTimer::print()).
+   */
+  template<class S1>
+  void report(const int c, const S1& s1);
+
+  /**
+   * Terminate.
+   */
+  void term();
+  //@}
+
+private:
+  /**
+   * Run the filter on the current perturbations, then update the swarm and
+   * point estimate from its final particles. If the filter fails, the
+   * log-likelihood is set to \f$-\infty\f$ and the swarm and point
+   * estimate are kept as they were.
+   */
+  template<class S1, class IO1>
+  void iterate(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s1, IO1& out);
+
+  /**
+   * Set standard deviations of perturbations for the current iteration.
+   */
+  template<class S1>
+  void perturbations(S1& s1);
+
+  /**
+   * Model.
+   */
+  B& m;
+
+  /**
+   * Filter.
+   */
+  F& filter;
+
+  /**
+   * Cooling factor.
+   */
+  double cooling;
+
+  /**
+   * Current multiplier on standard deviations of perturbations.
+   */
+  double scale;
+
+  /**
+   * Initial standard deviations of initial and random-walk perturbations.
+   */
+  real tau0, sigma0;
+
+  /**
+   * Offsets of @c tau_ and @c sigma_ in the parameters.
+   */
+  int tauStart, sigmaStart;
+
+  /**
+   * Offsets and sizes of perturbed parameters in the state, offsets of
+   * their means in the parameters, and offsets of the offsets of those
+   * means in the state.
+   */
+  std::vector<int> starts, sizes, starts0, startsc;
+
+  /**
+   * Total size of perturbed parameters.
+   */
+  int K;
+
+  /**
+   * Swarm of perturbed parameters at the end of the last iteration, after
+   * resampling. Rows index particles.
+   */
+  host_matrix<real> X;
+
+  /**
+   * Execution time by phase of the last iteration.
+   */
+  PhaseTimer timer;
+};
+}
+
+#include "../math/view.hpp"
+#include "../math/operation.hpp"
+#include "../primitive/matrix_primitive.hpp"
+#include "../pdf/misc.hpp"
+#include "../primitive/vector_primitive.hpp"
+#include "../misc/TicToc.hpp"
+
+#include <string>
+
+template<class B, class F>
+bi::IteratedFiltering<B,F>::IteratedFiltering(B& m, F& filter,
+    const double cooling) :
+    m(m), filter(filter), cooling(cooling), scale(1.0), tau0(0.0), sigma0(
+        0.0), tauStart(-1), sigmaStart(-1), K(0) {
+  /* pre-condition */
+  BI_ASSERT(cooling > 0.0 && cooling <= 1.0);
+
+  /* locate variables introduced by the iterated filtering transform */
+  const std::string suffix("_0_");
+  for (int id = 0; id < m.getNumVars(P_VAR); ++id) {
+    Var* var = m.getVar(P_VAR, id);
+    const std::string& name = var->getName();
+    if (name.compare("tau_") == 0) {
+      tauStart = var->getStart();
+    } else if (name.compare("sigma_") == 0) {
+      sigmaStart = var->getStart();
+    } else if (name.size() > suffix.size()
+        && name.compare(name.size() - suffix.size(), suffix.size(), suffix)
+            == 0) {
+      const std::string base(name, 0, name.size() - suffix.size());
+      const std::string centre(base + "_c_");
+      int start = -1, startc = -1, size = 0;
+      for (int id1 = 0; id1 < m.getNumVars(D_VAR); ++id1) {
+        Var* var1 = m.getVar(D_VAR, id1);
+        if (var1->getName().compare(base) == 0) {
+          BI_ERROR_MSG(var1->getSize() == var->getSize(),
+              "Variable " << name << " must have the same size as " << base);
+          start = var1->getStart();
+          size = var1->getSize();
+        } else if (var1->getName().compare(centre) == 0) {
+          startc = var1->getStart();
+        }
+      }
+      if (start >= 0) {
+        BI_ERROR_MSG(startc >= 0, "Variable " << centre << " not found, "
+            "model must be transformed with --with-transform-iterated-filtering");
+        starts.push_back(start);
+        sizes.push_back(size);
+        starts0.push_back(var->getStart());
+        startsc.push_back(startc);
+        K += size;
+      }
+    }
+  }
+  BI_ERROR_MSG(tauStart >= 0 && sigmaStart >= 0 && K > 0,
+      "Iterated filtering requires a model transformed with --with-transform-iterated-filtering");
+}
+
+template<class B, class F>
+template<class S1, class IO1, class IO2>
+void bi::IteratedFiltering<B,F>::sample(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    const int C, IO1& out, IO2& inInit) {
+  /* pre-condition */
+  BI_ERROR(C > 0);
+
+  TicToc clock;
+  init(rng, first, last, s.s, s.out, inInit);
+  report(0, s.s);
+  output(0, s.s, out);
+  for (int c = 1; c < C; ++c) {
+    step(rng, first, last, s.s, s.out);
+    report(c, s.s);
+    output(c, s.s, out);
+  }
+  s.clock = clock.toc();
+  outputT(s, out);
+  term();
+}
+
+template<class B, class F>
+template<class S1, class IO1, class IO2>
+void bi::IteratedFiltering<B,F>::init(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s1,
+    IO1& out, IO2& inInit) {
+  filter.init(rng, *first, s1, out, inInit);
+
+  host_vector<real> p(s1.get(P_VAR).size2());
+  p = row(s1.get(P_VAR), 0);
+  tau0 = p(tauStart);
+  sigma0 = p(sigmaStart);
+  scale = 1.0;
+
+  /* the initial block has drawn the first swarm around theta_0_ */
+  perturbations(s1);
+  iterate(rng, first, last, s1, out);
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::IteratedFiltering<B,F>::step(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s1,
+    IO1& out) {
+  /* pre-condition */
+  BI_ASSERT(X.size1() == s1.size());
+
+  host_vector<real> p(s1.get(P_VAR).size2());
+
+  /* restart the filter with the current point estimate and cooled
+   * perturbations, without sampling the parameter block; this refreshes
+   * inputs and observations from the caches */
+  scale *= cooling;
+  perturbations(s1);
+  p = row(s1.get(P_VAR), 0);
+  filter.init(p, *first, s1, out);
+
+  /* centre the initial draw of each particle on its member of the swarm,
+   * then draw initial values, so that the initial values of other state
+   * variables are conditional on the perturbed parameters of their own
+   * particle */
+  for (int i = 0, k = 0; i < (int)starts.size(); k += sizes[i], ++i) {
+    for (int j = 0; j < sizes[i]; ++j) {
+      BOOST_AUTO(c, column(s1.get(D_VAR), startsc[i] + j));
+      c = column(X, k + j);
+      addscal_elements(c, -p(starts0[i] + j), c);
+    }
+  }
+  m.initialSamples(rng, s1);
+  iterate(rng, first, last, s1, out);
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::IteratedFiltering<B,F>::iterate(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s1,
+    IO1& out) {
+  typedef typename temp_host_matrix<real>::type temp_matrix_type;
+  typedef typename temp_host_vector<real>::type temp_vector_type;
+  typedef typename temp_host_vector<int>::type temp_int_vector_type;
+
+  const int P = s1.size();
+  temp_matrix_type X1(P, K);
+  temp_vector_type lws(P), mu(K);
+  temp_int_vector_type as(P);
+  bool failed = false;
+
+  /* initial swarm, kept in case the filter fails on the first iteration */
+  if (X.size1() != P) {
+    X.resize(P, K, false);
+    for (int i = 0, k = 0; i < (int)starts.size(); k += sizes[i], ++i) {
+      columns(X, k, sizes[i]) = columns(s1.get(D_VAR), starts[i], sizes[i]);
+    }
+  }
+
+  try {
+    filter.filter(rng, first, last, s1, out);
+  } catch (CholeskyException e) {
+    failed = true;
+  } catch (ParticleFilterDegeneratedException e) {
+    failed = true;
+  }
+  timer = s1.timer;
+
+  /* on failure the weights are meaningless, so keep the previous swarm and
+   * point estimate */
+  if (failed) {
+    s1.logLikelihood = -BI_INF;
+    return;
+  }
+  filter.samplePath(rng, s1, out);
+
+  /* gather final swarm, resample, and take its mean as point estimate */
+  for (int i = 0, k = 0; i < (int)starts.size(); k += sizes[i], ++i) {
+    columns(X1, k, sizes[i]) = columns(s1.get(D_VAR), starts[i], sizes[i]);
+  }
+  lws = s1.logWeights();
+  rng.multinomials(lws, as);
+  X.resize(P, K, false);
+  gather_rows(as, X1, X);
+  mean(X, mu);
+  for (int i = 0, k = 0; i < (int)starts.size(); k += sizes[i], ++i) {
+    subrange(row(s1.get(P_VAR), 0), starts0[i], sizes[i]) = subrange(mu, k,
+        sizes[i]);
+  }
+  s1.get(PY_VAR) = s1.get(P_VAR);
+}
+
+template<class B, class F>
+template<class S1>
+void bi::IteratedFiltering<B,F>::perturbations(S1& s1) {
+  host_vector<real> p(s1.get(P_VAR).size2());
+  p = row(s1.get(P_VAR), 0);
+  p(tauStart) = scale*tau0;
+  p(sigmaStart) = scale*sigma0;
+  row(s1.get(P_VAR), 0) = p;
+  s1.get(PY_VAR) = s1.get(P_VAR);
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::IteratedFiltering<B,F>::output(const int c, const S1& s1,
+    IO1& out) {
+  out.write(c, s1);
+  if (out.isFull()) {
+    out.flush();
+    out.clear();
+  }
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::IteratedFiltering<B,F>::outputT(const S1& s, IO1& out) {
+  out.writeClock(s.clock);
+}
+
+template<class B, class F>
+template<class S1>
+void bi::IteratedFiltering<B,F>::report(const int c, const S1& s1) {
+  std::cerr << c << ":\t";
+  std::cerr.width(10);
+  std::cerr << s1.logLikelihood;
+  std::cerr << "\tscale=" << scale;
+  std::cerr << std::endl;
+  if (PhaseTimer::isEnabled()) {
+    std::cerr << "timing iter=" << c << ' ';
+    timer.print(std::cerr);
+    std::cerr << std::endl;
+  }
+}
+
+template<class B, class F>
+void bi::IteratedFiltering<B,F>::term() {
+  //
+}
+
+#endif
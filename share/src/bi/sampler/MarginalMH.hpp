@@ -7,7 +7,12 @@
 #define BI_SAMPLER_MARGINALMH_HPP
 
 #include "../state/Schedule.hpp"
+#include "../random/Random.hpp"
 #include "../misc/exception.hpp"
+#include "../misc/Checkpointer.hpp"
+#include "../misc/PhaseTimer.hpp"
+
+#include "boost/serialization/split_member.hpp"
 
 namespace bi {
 /**
@@ -22,6 +27,35 @@ namespace bi {
  * with a particle filter, gives the particle marginal Metropolis--Hastings
  * sampler described in @ref Andrieu2010 "Andrieu, Doucet \& Holenstein (2010)".
  *
+ * If a positive correlation is given, the sampler runs in a correlated
+ * pseudo-marginal mode. The schedule is divided into blocks (the initial
+ * state, the correction at the start time, then each step between
+ * observations), and the random numbers used by the filter in each block are
+ * drawn from a stream identified by a seed, kept with the filter state.
+ * Within a block, each thread draws from its own stream, a function of the
+ * seed and the thread. Particles are partitioned between threads statically,
+ * so that, with the same number of particles, each particle is processed by
+ * the same thread, and each thread consumes its stream for the same
+ * particles in the same order, in both the current and proposed runs. Filters
+ * that vary the number of particles, or schedule work dynamically, lose this
+ * correlation. On each proposal, the seed of each block is
+ * retained with probability given by the correlation, and otherwise
+ * refreshed. The proposal on seeds is reversible with respect to their
+ * distribution, so that the target is unchanged, while likelihood estimates
+ * of the current and proposed states are positively correlated. Combine with
+ * sorted resampling (Resampler::setSort()) to keep that correlation through
+ * resampling steps.
+ *
+ * If extension is enabled (setExtend()) and the output buffer already holds
+ * samples, the chain is extended from the last of them rather than started
+ * afresh, so that no burn-in is repeated. New samples are written after the
+ * existing ones.
+ *
+ * If a Checkpointer is set, the chain is checkpointed at the interval that
+ * it specifies, and resumed from the last checkpoint if one exists. At each
+ * checkpoint, samples so far are flushed to the output file, so that the
+ * file is consistent with the checkpoint.
+ *
  * @todo Add proposal adaptation using adapter classes.
  */
 template<class B, class F>
@@ -32,8 +66,42 @@ public:
    *
    * @param m Model.
    * @param filter Filter.
+   * @param rho Correlation; probability of retaining the random numbers of
+   * each block on each proposal. Zero to draw new random numbers for every
+   * proposal.
+   */
+  MarginalMH(B& m, F& filter, const double rho = 0.0);
+
+  /**
+   * Get inverse temperature.
+   */
+  double getInverseTemperature() const;
+
+  /**
+   * Set inverse temperature. The likelihood is raised to this power in the
+   * acceptance ratio; one (the default) targets the posterior.
    */
-  MarginalMH(B& m, F& filter);
+  void setInverseTemperature(const double beta);
+
+  /**
+   * Get acceptance rate.
+   */
+  double getAcceptRate() const;
+
+  /**
+   * Set checkpointer.
+   *
+   * @param checkpointer Checkpointer, or null to disable checkpointing.
+   */
+  void setCheckpointer(Checkpointer* checkpointer);
+
+  /**
+   * Set whether to extend a chain already in the output buffer.
+   *
+   * @param extend True to resume from the last sample in the output buffer,
+   * if it holds any, false to start afresh regardless.
+   */
+  void setExtend(const bool extend);
 
   /**
    * @name High-level interface
@@ -53,7 +121,8 @@ public:
    * @param last End of time schedule.
    * @param s State.
    * @param C Number of samples to draw.
-   * @param out Output buffer.
+   * @param out Output buffer. If extension is enabled and it already holds
+   * samples, @p C further samples are appended to them.
    * @param inInit Initialisation file.
    */
   template<class S1, class IO1, class IO2>
@@ -86,6 +155,33 @@ public:
   void init(Random& rng, const ScheduleIterator first,
       const ScheduleIterator last, S1& s1, IO1& out, IO2& inInit);
 
+  /**
+   * Resume chain from the last sample in an output buffer.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   * @tparam IO2 Output type.
+   * @tparam IO3 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[out] s1 State.
+   * @param[in,out] out Output buffer of filter.
+   * @param in Output buffer of chain, from which to resume.
+   * @param inInit Initialisation file.
+   *
+   * The parameters, log-likelihood and log-prior density of the last sample
+   * are restored. The filter is run once with those parameters, to sample a
+   * new path. In correlated mode the random numbers of the last sample are
+   * not in the buffer, so new ones are drawn, and the likelihood estimate
+   * made with them replaces the restored one, so that the estimate and the
+   * random numbers of the chain state agree.
+   */
+  template<class S1, class IO1, class IO2, class IO3>
+  void resume(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s1, IO1& out, IO2& in, IO3& inInit);
+
   /**
    * Propose new state.
    *
@@ -119,6 +215,22 @@ public:
   template<class S1, class S2, class IO1>
   bool acceptReject(Random& rng, S1& s1, S2& s2, IO1& out);
 
+  /**
+   * Run filter, drawing the random numbers for each block from the stream
+   * given by its seed.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   * @param[in,out] out Output buffer.
+   */
+  template<class S1, class IO1>
+  void filterCorrelated(const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, IO1& out);
+
   /**
    * Output.
    *
@@ -138,6 +250,20 @@ public:
   template<class S1, class IO1>
   void outputT(const S1& s, IO1& out);
 
+  /**
+   * Flush output and write checkpoint.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param c Index of the next sample.
+   * @param rng Random number generator.
+   * @param s State.
+   * @param[in,out] out Output buffer.
+   */
+  template<class S1, class IO1>
+  void checkpoint(const int c, const Random& rng, const S1& s, IO1& out);
+
   /**
    * Report progress on stderr.
    *
@@ -147,6 +273,11 @@ public:
    * @param c Number of steps taken.
    * @param s1 Current state.
    * @param s2 Alternative state.
+   *
+   * If timing is enabled (PhaseTimer::setEnabled()), the progress line is
+   * followed by a line beginning @c timing, giving the execution
+   * time of the proposal by phase, as @c name=microseconds pairs
+   * (see PhaseTimer::print()).
    */
   template<class S1, class S2>
   void report(const int c, const S1& s1, const S2& s2);
@@ -168,6 +299,21 @@ private:
    */
   F& filter;
 
+  /**
+   * Correlation.
+   */
+  double rho;
+
+  /**
+   * Inverse temperature.
+   */
+  double beta;
+
+  /**
+   * Random number generator for filter in correlated mode.
+   */
+  Random rngFilter;
+
   /**
    * Was the last proposal accepted?
    */
@@ -182,15 +328,85 @@ private:
    * Total number of proposals.
    */
   int total;
+
+  /**
+   * Index in output of the first sample of this run.
+   */
+  int offset;
+
+  /**
+   * Execution time by phase of the last proposal.
+   */
+  PhaseTimer timer;
+
+  /**
+   * Checkpointer.
+   */
+  Checkpointer* checkpointer;
+
+  /**
+   * Extend a chain already in the output buffer?
+   */
+  bool extend;
+
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
 };
 }
 
 #include "../misc/TicToc.hpp"
 
+#include <limits>
+
 template<class B, class F>
-bi::MarginalMH<B,F>::MarginalMH(B& m, F& filter) :
-    m(m), filter(filter), lastAccepted(false), accepted(0), total(0) {
-  //
+bi::MarginalMH<B,F>::MarginalMH(B& m, F& filter, const double rho) :
+    m(m), filter(filter), rho(rho), beta(1.0), lastAccepted(false), accepted(
+        0), total(0), offset(0), checkpointer(NULL), extend(false) {
+  /* pre-condition */
+  BI_ASSERT(rho >= 0.0 && rho <= 1.0);
+}
+
+template<class B, class F>
+inline double bi::MarginalMH<B,F>::getInverseTemperature() const {
+  return beta;
+}
+
+template<class B, class F>
+inline void bi::MarginalMH<B,F>::setInverseTemperature(const double beta) {
+  /* pre-condition */
+  BI_ASSERT(beta >= 0.0 && beta <= 1.0);
+
+  this->beta = beta;
+}
+
+template<class B, class F>
+inline double bi::MarginalMH<B,F>::getAcceptRate() const {
+  return (total > 0) ? (double)accepted / total : 0.0;
+}
+
+template<class B, class F>
+inline void bi::MarginalMH<B,F>::setCheckpointer(Checkpointer* checkpointer) {
+  this->checkpointer = checkpointer;
+}
+
+template<class B, class F>
+inline void bi::MarginalMH<B,F>::setExtend(const bool extend) {
+  this->extend = extend;
 }
 
 template<class B, class F>
@@ -201,13 +417,26 @@ void bi::MarginalMH<B,F>::sample(Random& rng, const ScheduleIterator first,
   BI_ERROR(C > 0);
 
   TicToc clock;
-  init(rng, first, last, s.s1, s.out, inInit);
-  output(0, s.s1, out);
-  for (int c = 1; c < C; ++c) {
+  int c0 = 1;
+  if (checkpointer != NULL && checkpointer->canRestore()) {
+    checkpointer->load(c0, rng, s, *this);
+  } else if (extend && out.countSamples() > 0) {
+    offset = out.countSamples();
+    resume(rng, first, last, s.s1, s.out, out, inInit);
+    c0 = 0;
+  } else {
+    offset = 0;
+    init(rng, first, last, s.s1, s.out, inInit);
+    output(0, s.s1, out);
+  }
+  for (int c = c0; c < C; ++c) {
     propose(rng, first, last, s.s1, s.s2, s.out);
     acceptReject(rng, s.s1, s.s2, s.out);
-    report(c, s.s1, s.s2);
-    output(c, s.s1, out);
+    report(offset + c, s.s1, s.s2);
+    output(offset + c, s.s1, out);
+    if (checkpointer != NULL && checkpointer->isDue()) {
+      checkpoint(c + 1, rng, s, out);
+    }
   }
   s.clock = clock.toc();
   outputT(s, out);
@@ -219,21 +448,84 @@ template<class S1, class IO1, class IO2>
 void bi::MarginalMH<B,F>::init(Random& rng, const ScheduleIterator first,
     const ScheduleIterator last, S1& s1, IO1& out, IO2& inInit) {
   filter.init(rng, *first, s1, out, inInit);
-  filter.filter(rng, first, last, s1, out);
+  if (rho > 0.0) {
+    /* redraw initial values from the stream of the first block, as for
+     * proposals */
+    for (int k = 0; k < s1.seeds.size(); ++k) {
+      s1.seeds(k) = rng.uniformInt(0, std::numeric_limits<int>::max());
+    }
+    rngFilter.seeds(s1.seeds(0));
+    m.initialSamples(rngFilter, s1);
+    filterCorrelated(first, last, s1, out);
+  } else {
+    filter.filter(rng, first, last, s1, out);
+  }
   filter.samplePath(rng, s1, out);
   lastAccepted = true;
   accepted = 1;
   total = 1;
 }
 
+template<class B, class F>
+template<class S1, class IO1, class IO2, class IO3>
+void bi::MarginalMH<B,F>::resume(Random& rng, const ScheduleIterator first,
+    const ScheduleIterator last, S1& s1, IO1& out, IO2& in, IO3& inInit) {
+  const int p = in.countSamples() - 1;
+
+  /* restore parameters, then redraw initial conditions given them */
+  filter.init(rng, *first, s1, out, inInit);
+  in.readParameters(p, s1.get(P_VAR));
+  s1.get(PY_VAR) = s1.get(P_VAR);
+
+  if (rho > 0.0) {
+    /* new random numbers, so the new likelihood estimate is kept */
+    for (int k = 0; k < s1.seeds.size(); ++k) {
+      s1.seeds(k) = rng.uniformInt(0, std::numeric_limits<int>::max());
+    }
+    rngFilter.seeds(s1.seeds(0));
+    m.initialSamples(rngFilter, s1);
+    filterCorrelated(first, last, s1, out);
+    filter.samplePath(rng, s1, out);
+  } else {
+    /* the likelihood estimate of the chain is kept, not the new one */
+    m.initialSamples(rng, s1);
+    filter.filter(rng, first, last, s1, out);
+    filter.samplePath(rng, s1, out);
+    s1.logLikelihood = in.readLogLikelihood(p);
+  }
+  s1.logPrior = in.readLogPrior(p);
+
+  lastAccepted = true;
+  accepted = 0;
+  total = 0;
+}
+
 template<class B, class F>
 template<class S1, class S2, class IO1>
 void bi::MarginalMH<B,F>::propose(Random& rng, const ScheduleIterator first,
     const ScheduleIterator last, S1& s1, S2& s2, IO1& out) {
   try {
     filter.propose(rng, *first, s1, s2, out);
+    s2.timer.reset();
+    if (rho > 0.0) {
+      /* retain or refresh the seed of each block, then redraw initial
+       * values from the stream of the first */
+      for (int k = 0; k < s2.seeds.size(); ++k) {
+        if (rng.uniform(0.0, 1.0) < rho) {
+          s2.seeds(k) = s1.seeds(k);
+        } else {
+          s2.seeds(k) = rng.uniformInt(0, std::numeric_limits<int>::max());
+        }
+      }
+      rngFilter.seeds(s2.seeds(0));
+      m.initialSamples(rngFilter, s2);
+    }
     if (bi::is_finite(s2.logPrior)) {
-      filter.filter(rng, first, last, s2, out);
+      if (rho > 0.0) {
+        filterCorrelated(first, last, s2, out);
+      } else {
+        filter.filter(rng, first, last, s2, out);
+      }
     } else {
       s2.logLikelihood = -BI_INF;
     }
@@ -242,6 +534,7 @@ void bi::MarginalMH<B,F>::propose(Random& rng, const ScheduleIterator first,
   } catch (ParticleFilterDegeneratedException e) {
     s2.logLikelihood = -BI_INF;
   }
+  timer = s2.timer;
 }
 
 template<class B, class F>
@@ -252,7 +545,7 @@ bool bi::MarginalMH<B,F>::acceptReject(Random& rng, S1& s1, S2& s2, IO1& out) {
   } else if (!bi::is_finite(s1.logLikelihood)) {
     lastAccepted = true;
   } else {
-    double loglr = s2.logLikelihood - s1.logLikelihood;
+    double loglr = beta*(s2.logLikelihood - s1.logLikelihood);
     double logpr = s2.logPrior - s1.logPrior;
     double logqr = s1.logProposal == BI_INF && s2.logProposal == BI_INF ? 0 : s1.logProposal - s2.logProposal;
     double logratio = loglr + logpr + logqr;
@@ -271,6 +564,28 @@ bool bi::MarginalMH<B,F>::acceptReject(Random& rng, S1& s1, S2& s2, IO1& out) {
   return lastAccepted;
 }
 
+template<class B, class F>
+template<class S1, class IO1>
+void bi::MarginalMH<B,F>::filterCorrelated(const ScheduleIterator first,
+    const ScheduleIterator last, S1& s, IO1& out) {
+  TicToc clock;
+  ScheduleIterator iter = first;
+  int k = 1;  // block 0 is the initial state, drawn by the caller
+
+  rngFilter.seeds(s.seeds(k));
+  filter.output0(s, out);
+  filter.correct(rngFilter, *iter, s);
+  filter.output(*iter, s, out);
+  while (iter + 1 != last) {
+    k = bi::min(k + 1, static_cast<int>(s.seeds.size()) - 1);
+    rngFilter.seeds(s.seeds(k));
+    filter.step(rngFilter, iter, last, s, out);
+  }
+  filter.term(s);
+  s.clock = clock.toc();
+  filter.outputT(s, out);
+}
+
 template<class B, class F>
 template<class S1, class IO1>
 void bi::MarginalMH<B,F>::output(const int c, const S1& s1, IO1& out) {
@@ -287,6 +602,18 @@ void bi::MarginalMH<B,F>::outputT(const S1& s, IO1& out) {
   out.writeClock(s.clock);
 }
 
+template<class B, class F>
+template<class S1, class IO1>
+void bi::MarginalMH<B,F>::checkpoint(const int c, const Random& rng,
+    const S1& s, IO1& out) {
+  if (!out.isEmpty()) {
+    out.flush();
+    out.clear();
+  }
+  out.sync();
+  checkpointer->save(c, rng, s, *this);
+}
+
 template<class B, class F>
 template<class S1, class S2>
 void bi::MarginalMH<B,F>::report(const int c, const S1& s1, const S2& s2) {
@@ -314,6 +641,11 @@ void bi::MarginalMH<B,F>::report(const int c, const S1& s1, const S2& s2) {
   }
   std::cerr << "\taccept=" << (double)accepted / total;
   std::cerr << std::endl;
+  if (PhaseTimer::isEnabled()) {
+    std::cerr << "timing iter=" << c << ' ';
+    timer.print(std::cerr);
+    std::cerr << std::endl;
+  }
 }
 
 template<class B, class F>
@@ -321,4 +653,22 @@ void bi::MarginalMH<B,F>::term() {
   //
 }
 
+template<class B, class F>
+template<class Archive>
+void bi::MarginalMH<B,F>::save(Archive& ar, const unsigned version) const {
+  ar & offset;
+  ar & lastAccepted;
+  ar & accepted;
+  ar & total;
+}
+
+template<class B, class F>
+template<class Archive>
+void bi::MarginalMH<B,F>::load(Archive& ar, const unsigned version) {
+  ar & offset;
+  ar & lastAccepted;
+  ar & accepted;
+  ar & total;
+}
+
 #endif
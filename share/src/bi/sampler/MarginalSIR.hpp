@@ -10,10 +10,17 @@
 #include "../state/Schedule.hpp"
 #include "../misc/exception.hpp"
 #include "../misc/TicToc.hpp"
+#include "../misc/omp.hpp"
+#include "../misc/Checkpointer.hpp"
+#include "../misc/PhaseTimer.hpp"
 #include "../primitive/vector_primitive.hpp"
 
+#include "boost/serialization/split_member.hpp"
+
+#include <vector>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 namespace bi {
 /**
@@ -29,6 +36,19 @@ namespace bi {
  * Implements sequential importance resampling over parameters, which, when
  * combined with a particle filter, gives the SMC^2 method described in
  * @ref Chopin2013 "Chopin, Jacob \& Papaspiliopoulos (2013)".
+ *
+ * Move steps run concurrently, each thread moving its own block of
+ * \f$\theta\f$-particles. When a real time budget is given for move steps,
+ * each thread cycles through its block until the milestone for the current
+ * step, and the particle that it is moving at that time is eliminated, as in
+ * the anytime framework of @ref Murray2016 "Murray et al. (2016)". The
+ * resampler must then be in anytime mode, to correct the marginal likelihood
+ * estimate for these eliminations.
+ *
+ * If a Checkpointer is set, the run is checkpointed after the interaction
+ * step at each observation, once the interval that it specifies has passed,
+ * and resumed from the last checkpoint if one exists. With MPI, all
+ * processes checkpoint at the same step.
  */
 template<class B, class F, class A, class R>
 class MarginalSIR {
@@ -47,6 +67,11 @@ public:
   MarginalSIR(B& m, F& filter, A& adapter, R& resam, const int nmoves = 1,
       const long tmoves = 0.0);
 
+  /**
+   * @copydoc MarginalMH::setCheckpointer()
+   */
+  void setCheckpointer(Checkpointer* checkpointer);
+
   /**
    * @name High-level interface
    */
@@ -129,6 +154,34 @@ public:
   template<class S1, class IO1>
   void outputT(const S1& s, IO1& out);
 
+  /**
+   * Write checkpoint, if one is due.
+   *
+   * @tparam S1 State type.
+   *
+   * @param first Start of time schedule.
+   * @param iter Current position in time schedule.
+   * @param rng Random number generator.
+   * @param s State.
+   */
+  template<class S1>
+  void checkpoint(const ScheduleIterator first, const ScheduleIterator iter,
+      const Random& rng, const S1& s);
+
+  /**
+   * Restore from checkpoint.
+   *
+   * @tparam S1 State type.
+   *
+   * @param first Start of time schedule.
+   * @param[out] iter Position in time schedule at checkpoint.
+   * @param[out] rng Random number generator.
+   * @param[out] s State.
+   */
+  template<class S1>
+  void restore(const ScheduleIterator first, ScheduleIterator& iter,
+      Random& rng, S1& s);
+
   /**
    * Report progress on stderr.
    *
@@ -143,6 +196,11 @@ public:
    *
    * @param now Current step in time schedule.
    * @param s State.
+   *
+   * If timing is enabled (PhaseTimer::setEnabled()), the progress line is
+   * followed by a line beginning @c timing, giving the execution
+   * time of the step by phase, as @c name=microseconds pairs
+   * (see PhaseTimer::print()). Times of filters are summed over threads.
    */
   template<class S1>
   void report(const ScheduleElement now, S1& s);
@@ -208,6 +266,11 @@ private:
    */
   TicToc clock;
 
+  /**
+   * Execution time by phase of the current step.
+   */
+  PhaseTimer timer;
+
   /**
    * Number of PMMH steps when moving.
    */
@@ -247,6 +310,29 @@ private:
    * Last total number of moves.
    */
   int lastTotal;
+
+  /**
+   * Checkpointer.
+   */
+  Checkpointer* checkpointer;
+
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
 };
 }
 
@@ -255,7 +341,7 @@ bi::MarginalSIR<B,F,A,R>::MarginalSIR(B& m, F& filter, A& adapter, R& resam,
     const int nmoves, const long tmoves) :
     m(m), filter(filter), adapter(adapter), resam(resam), nmoves(nmoves), tmoves(
         1e6 * tmoves), tstart(0), tmilestone(0), lastResample(false), adapterReady(
-        false), lastAccept(0), lastTotal(0) {
+        false), lastAccept(0), lastTotal(0), checkpointer(NULL) {
 #if ENABLE_DIAGNOSTICS == 4
 #ifdef ENABLE_MPI
   boost::mpi::communicator world;
@@ -274,10 +360,16 @@ bi::MarginalSIR<B,F,A,R>::MarginalSIR(B& m, F& filter, A& adapter, R& resam,
 #endif
 
   if (tmoves > 0.0) {
-    this->nmoves = 1;  // one move at a time only
+    this->nmoves = 1;  // one move at a time per thread only
   }
 }
 
+template<class B, class F, class A, class R>
+inline void bi::MarginalSIR<B,F,A,R>::setCheckpointer(
+    Checkpointer* checkpointer) {
+  this->checkpointer = checkpointer;
+}
+
 template<class B, class F, class A, class R>
 template<class S1, class IO1, class IO2>
 void bi::MarginalSIR<B,F,A,R>::sample(Random& rng,
@@ -285,12 +377,18 @@ void bi::MarginalSIR<B,F,A,R>::sample(Random& rng,
     const int C, IO1& out, IO2& inInit) {
   TicToc clock;
   ScheduleIterator iter = first;
-  init(rng, iter, s, out, inInit);
-  profile(INIT);
-  profile(INTERACT);
-  interact(rng, *iter, s);
+  if (checkpointer != NULL && checkpointer->canRestore()) {
+    restore(first, iter, rng, s);
+    profile(INIT);
+  } else {
+    init(rng, iter, s, out, inInit);
+    profile(INIT);
+    profile(INTERACT);
+    interact(rng, *iter, s);
+  }
   report0(*iter, s);
   while (iter + 1 != last) {
+    checkpoint(first, iter, rng, s);
     profile(MOVE);
     move(rng, first, iter, last, s);
     profile(STEP);
@@ -337,6 +435,7 @@ void bi::MarginalSIR<B,F,A,R>::init(Random& rng, const ScheduleIterator first,
   }
   out.clear();
 
+  resam.setNumEliminated(0);
   lastResample = false;
   adapterReady = false;
   lastAccept = 0;
@@ -357,8 +456,10 @@ void bi::MarginalSIR<B,F,A,R>::step(Random& rng, const ScheduleIterator first,
       BOOST_AUTO(&out1, *s.out1s[p]);
 
       iter1 = iter;
+      s1.timer.reset();
       filter.step(rng, iter1, last, s1, out1);
       s.logWeights()(p) += s1.logIncrements(iter1->indexObs());
+      timer.add(s1.timer);
     }
     iter = iter1;
   } while (iter + 1 != last && !iter->isObserved());
@@ -371,6 +472,11 @@ template<class B, class F, class A, class R>
 template<class S1>
 void bi::MarginalSIR<B,F,A,R>::interact(Random& rng,
     const ScheduleElement now, S1& s) {
+  /* time spent waiting on other processes to finish their step */
+  timer.tic();
+  mpi_barrier();
+  timer.toc(PHASE_WAIT);
+
 #ifdef ENABLE_MPI
   /* reporting requirements */
   boost::mpi::communicator world;
@@ -387,9 +493,11 @@ void bi::MarginalSIR<B,F,A,R>::interact(Random& rng,
 
   /* adapt proposal */
   adapterReady = adapter.adapt(s);
+  timer.toc(PHASE_REDUCE);
 
   /* resample */
   lastResample = resam.resample(rng, now, s);
+  timer.toc(PHASE_RESAMPLE);
 }
 
 template<class B, class F, class A, class R>
@@ -405,83 +513,109 @@ void bi::MarginalSIR<B,F,A,R>::move(Random& rng, const ScheduleIterator first,
   tmilestone = tstart + tmoves*2.0*(t + c)/(T*(T + 2*c + 1));
 
   if (lastResample) {
+    const int P = s.size();
+    const int K = std::min(bi_omp_max_threads, P);
+    std::vector<PhaseTimer> timers(K);
     int naccept = 0;
     int ntotal = 0;
-    int j = 0;
-    int p = 0;
-    bool accept = false;
-    bool complete = (tmoves <= 0 && p >= s.size())
-        || (tmoves > 0 && clock.toc() >= tmilestone);
+    int nelim = 0;
+    int k;
 
     if (tmoves > 0) {
-      /* serial schedule, but random order */
+      /* random order */
       resam.shuffle(rng, s);
     }
-    while (!complete) {
-      j = p % s.size();
-      BOOST_AUTO(&s1, *s.s1s[j]);
-      BOOST_AUTO(&out1, *s.out1s[j]);
-      BOOST_AUTO(&s2, s.s2);
-      BOOST_AUTO(&out2, s.out2);
-
-      for (int move = 0; move < nmoves; ++move) {
-        /* propose replacement */
-        try {
-          if (adapterReady) {
-            filter.propose(rng, *first, s1, s2, out2, adapter);
-          } else {
-            filter.propose(rng, *first, s1, s2, out2);
-          }
-          if (tmoves > 0) {
-            filter.filter(rng, first, iter + 1, s2, out2, clock, tmilestone);
-          } else {
-            filter.filter(rng, first, iter + 1, s2, out2);
-          }
-        } catch (CholeskyException e) {
-          s2.logLikelihood = -BI_INF;
-        } catch (ParticleFilterDegeneratedException e) {
-          s2.logLikelihood = -BI_INF;
-        }
-        if (tmoves <= 0 || clock.toc() < tmilestone) {
-          /* accept or reject */
-          if (!bi::is_finite(s2.logLikelihood)) {
-            accept = false;
-          } else if (!bi::is_finite(s1.logLikelihood)) {
-            accept = true;
-          } else {
-            double loglr = s2.logLikelihood - s1.logLikelihood;
-            double logpr = s2.logPrior - s1.logPrior;
-            double logqr = s1.logProposal - s2.logProposal;
-            double logratio = loglr + logpr + logqr;
-            double u = rng.uniform<double>();
-
-            accept = bi::log(u) < logratio;
+
+    /* each thread moves its own contiguous block of particles, in anytime
+     * mode cycling through the block until the milestone is reached */
+    #pragma omp parallel for reduction(+:naccept,ntotal,nelim) schedule(static,1)
+    for (k = 0; k < K; ++k) {
+      const int pstart = k * P / K;
+      const int pend = (k + 1) * P / K;
+      int j = pstart;
+      int p = pstart;
+      bool accept = false;
+      bool complete = (tmoves <= 0 && p >= pend)
+          || (tmoves > 0 && clock.toc() >= tmilestone);
+
+      BOOST_AUTO(&s2, *s.s2s[k]);
+      BOOST_AUTO(&out2, *s.out2s[k]);
+
+      while (!complete) {
+        j = pstart + (p - pstart) % (pend - pstart);
+        BOOST_AUTO(&s1, *s.s1s[j]);
+        BOOST_AUTO(&out1, *s.out1s[j]);
+
+        for (int move = 0; move < nmoves; ++move) {
+          /* propose replacement */
+          try {
+            if (adapterReady) {
+              filter.propose(rng, *first, s1, s2, out2, adapter);
+            } else {
+              filter.propose(rng, *first, s1, s2, out2);
+            }
+            if (tmoves > 0) {
+              filter.filter(rng, first, iter + 1, s2, out2, clock,
+                  tmilestone);
+            } else {
+              filter.filter(rng, first, iter + 1, s2, out2);
+            }
+          } catch (CholeskyException e) {
+            s2.logLikelihood = -BI_INF;
+          } catch (ParticleFilterDegeneratedException e) {
+            s2.logLikelihood = -BI_INF;
           }
-          if (accept) {
+          timers[k].add(s2.timer);
+          if (tmoves <= 0 || clock.toc() < tmilestone) {
+            /* accept or reject */
+            if (!bi::is_finite(s2.logLikelihood)) {
+              accept = false;
+            } else if (!bi::is_finite(s1.logLikelihood)) {
+              accept = true;
+            } else {
+              double loglr = s2.logLikelihood - s1.logLikelihood;
+              double logpr = s2.logPrior - s1.logPrior;
+              double logqr = s1.logProposal - s2.logProposal;
+              double logratio = loglr + logpr + logqr;
+              double u = rng.uniform<double>();
+
+              accept = bi::log(u) < logratio;
+            }
+            if (accept) {
   #if ENABLE_DIAGNOSTICS == 3
-            filter.samplePath(rng, s2, out2);
+              filter.samplePath(rng, s2, out2);
   #endif
-            s1.swap(s2);
-            out1.swap(out2);
-            ++naccept;
+              s1.swap(s2);
+              out1.swap(out2);
+              ++naccept;
+            }
+            ++ntotal;
           }
-          ++ntotal;
         }
+        ++p;
+        complete = (tmoves <= 0 && p >= pend)
+            || (tmoves > 0 && clock.toc() >= tmilestone);
+      }
+
+      if (tmoves > 0 && p > pstart) {
+        /* eliminate active particle; a thread that reached the milestone
+         * before its first proposal has none */
+        s.logWeights()(j) = -BI_INF;
+        ++nelim;
       }
-      ++p;
-      complete = (tmoves <= 0 && p >= s.size())
-          || (tmoves > 0 && clock.toc() >= tmilestone);
     }
 
-    if (tmoves > 0) {
-      /* eliminate active particle, note Resampler and DistributedResampler
-       * corrects the marginal likelihood estimate correctly for this */
-      s.logWeights()(j) = -BI_INF;
+    for (k = 0; k < K; ++k) {
+      timer.add(timers[k]);
     }
 
+    /* Resampler and DistributedResampler correct the marginal likelihood
+     * estimate for the eliminated particles, one per thread that moved */
+    resam.setNumEliminated(nelim);
     lastAccept = naccept;
     lastTotal = ntotal;
   } else {
+    resam.setNumEliminated(0);
     lastAccept = 0;
     lastTotal = 0;
   }
@@ -494,6 +628,39 @@ void bi::MarginalSIR<B,F,A,R>::outputT(const S1& s, IO1& out) {
   out.writeClock(s.clock);
 }
 
+template<class B, class F, class A, class R>
+template<class S1>
+void bi::MarginalSIR<B,F,A,R>::checkpoint(const ScheduleIterator first,
+    const ScheduleIterator iter, const Random& rng, const S1& s) {
+  if (checkpointer != NULL) {
+    bool due = checkpointer->isDue();
+#ifdef ENABLE_MPI
+    /* all processes must checkpoint at the same step */
+    boost::mpi::communicator world;
+    boost::mpi::broadcast(world, due, 0);
+#endif
+    if (due) {
+      int k = iter - first;
+      checkpointer->save(k, rng, s, *this);
+    }
+  }
+}
+
+template<class B, class F, class A, class R>
+template<class S1>
+void bi::MarginalSIR<B,F,A,R>::restore(const ScheduleIterator first,
+    ScheduleIterator& iter, Random& rng, S1& s) {
+  int k;
+  checkpointer->load(k, rng, s, *this);
+#ifdef ENABLE_MPI
+  boost::mpi::communicator world;
+  int kmin = boost::mpi::all_reduce(world, k, boost::mpi::minimum<int>());
+  int kmax = boost::mpi::all_reduce(world, k, boost::mpi::maximum<int>());
+  BI_ERROR_MSG(kmin == kmax, "Checkpoints of processes are from different steps");
+#endif
+  iter = first + k;
+}
+
 template<class B, class F, class A, class R>
 template<class S1>
 void bi::MarginalSIR<B,F,A,R>::report0(const ScheduleElement now, S1& s) {
@@ -525,7 +692,13 @@ void bi::MarginalSIR<B,F,A,R>::reportT(const ScheduleElement now, S1& s) {
       std::cerr << "\trate " << (double(lastAccept) / lastTotal);
     }
     std::cerr << std::endl;
+    if (PhaseTimer::isEnabled()) {
+      std::cerr << "timing step=" << now.indexOutput() << ' ';
+      timer.print(std::cerr);
+      std::cerr << std::endl;
+    }
   }
+  timer.reset();
 }
 
 template<class B, class F, class A, class R>
@@ -553,4 +726,25 @@ void bi::MarginalSIR<B,F,A,R>::profile(const Step step) {
 #endif
 }
 
+template<class B, class F, class A, class R>
+template<class Archive>
+void bi::MarginalSIR<B,F,A,R>::save(Archive& ar,
+    const unsigned version) const {
+  ar & adapter;
+  ar & lastResample;
+  ar & adapterReady;
+  ar & lastAccept;
+  ar & lastTotal;
+}
+
+template<class B, class F, class A, class R>
+template<class Archive>
+void bi::MarginalSIR<B,F,A,R>::load(Archive& ar, const unsigned version) {
+  ar & adapter;
+  ar & lastResample;
+  ar & adapterReady;
+  ar & lastAccept;
+  ar & lastTotal;
+}
+
 #endif
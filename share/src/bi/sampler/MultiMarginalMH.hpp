@@ -0,0 +1,274 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_SAMPLER_MULTIMARGINALMH_HPP
+#define BI_SAMPLER_MULTIMARGINALMH_HPP
+
+#include "MarginalMH.hpp"
+
+#include <vector>
+#include <algorithm>
+
+namespace bi {
+/**
+ * Multiple-chain marginal Metropolis-Hastings.
+ *
+ * @ingroup method_sampler
+ *
+ * @tparam B Model type
+ * @tparam F Filter type.
+ *
+ * Runs several independent MarginalMH chains in lockstep within the one
+ * process. All chains share the model, filter, forcer and observer (and so
+ * their input caches), and write to the one output buffer. Sample @c c of
+ * chain @c k is written at index <tt>c*K + k</tt>, where @c K is the number
+ * of chains, so that the output of each step is contiguous.
+ *
+ * Chains are stepped one after another, not batched: the particles of all
+ * chains are not stacked into a single filter run, as State holds only one
+ * set of parameters. Each chain's filter instead uses all threads over its
+ * own particles, as for a single chain.
+ */
+template<class B, class F>
+class MultiMarginalMH {
+public:
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param filter Filter.
+   * @param rho Correlation, see MarginalMH.
+   */
+  MultiMarginalMH(B& m, F& filter, const double rho = 0.0);
+
+  /**
+   * @name High-level interface
+   *
+   * An easier interface for common usage.
+   */
+  //@{
+  /**
+   * Sample.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param s State.
+   * @param C Number of samples to draw for each chain.
+   * @param out Output buffer.
+   * @param inInit Initialisation file.
+   */
+  template<class S1, class IO1, class IO2>
+  void sample(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, const int C, IO1& out, IO2& inInit);
+  //@}
+
+  /**
+   * @name Low-level interface
+   *
+   * Largely used by other features of the library or for finer control over
+   * performance and behaviour.
+   */
+  //@{
+  /**
+   * Initialise starting state of all chains.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[out] s State.
+   * @param inInit Initialisation file.
+   */
+  template<class S1, class IO1>
+  void init(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, IO1& inInit);
+
+  /**
+   * Take one step of all chains.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void step(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s);
+
+  /**
+   * Output current state of all chains.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param c Step index.
+   * @param s State.
+   * @param[in,out] out Output buffer.
+   */
+  template<class S1, class IO1>
+  void output(const int c, const S1& s, IO1& out);
+
+  /**
+   * @copydoc Simulator::outputT()
+   */
+  template<class S1, class IO1>
+  void outputT(const S1& s, IO1& out);
+
+  /**
+   * Report progress on stderr.
+   *
+   * @tparam S1 State type.
+   *
+   * @param c Number of steps taken.
+   * @param s State.
+   */
+  template<class S1>
+  void report(const int c, const S1& s);
+
+  /**
+   * Terminate.
+   */
+  void term();
+  //@}
+
+private:
+  /**
+   * Model.
+   */
+  B& m;
+
+  /**
+   * Filter.
+   */
+  F& filter;
+
+  /**
+   * Single-chain sampler used to step each chain.
+   */
+  MarginalMH<B,F> mh;
+
+  /**
+   * Number of accepted proposals for each chain.
+   */
+  std::vector<int> accepted;
+
+  /**
+   * Total number of proposals for each chain.
+   */
+  int total;
+};
+}
+
+#include "../misc/TicToc.hpp"
+
+template<class B, class F>
+bi::MultiMarginalMH<B,F>::MultiMarginalMH(B& m, F& filter,
+    const double rho) :
+    m(m), filter(filter), mh(m, filter, rho), total(0) {
+  //
+}
+
+template<class B, class F>
+template<class S1, class IO1, class IO2>
+void bi::MultiMarginalMH<B,F>::sample(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    const int C, IO1& out, IO2& inInit) {
+  /* pre-condition */
+  BI_ERROR(C > 0);
+
+  TicToc clock;
+  init(rng, first, last, s, inInit);
+  output(0, s, out);
+  for (int c = 1; c < C; ++c) {
+    step(rng, first, last, s);
+    report(c, s);
+    output(c, s, out);
+  }
+  s.clock = clock.toc();
+  outputT(s, out);
+  term();
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::MultiMarginalMH<B,F>::init(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    IO1& inInit) {
+  for (int k = 0; k < s.size(); ++k) {
+    mh.init(rng, first, last, s.select(k).s1, s.select(k).out, inInit);
+  }
+  accepted.resize(s.size());
+  std::fill(accepted.begin(), accepted.end(), 1);
+  total = 1;
+}
+
+template<class B, class F>
+template<class S1>
+void bi::MultiMarginalMH<B,F>::step(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s) {
+  for (int k = 0; k < s.size(); ++k) {
+    typename S1::chain_type& chain = s.select(k);
+    mh.propose(rng, first, last, chain.s1, chain.s2, chain.out);
+    if (mh.acceptReject(rng, chain.s1, chain.s2, chain.out)) {
+      ++accepted[k];
+    }
+  }
+  ++total;
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::MultiMarginalMH<B,F>::output(const int c, const S1& s, IO1& out) {
+  const int K = s.size();
+  for (int k = 0; k < K; ++k) {
+    out.write(c*K + k, s.chains[k]->s1);
+    if (out.isFull()) {
+      out.flush();
+      out.clear();
+    }
+  }
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::MultiMarginalMH<B,F>::outputT(const S1& s, IO1& out) {
+  out.writeClock(s.clock);
+}
+
+template<class B, class F>
+template<class S1>
+void bi::MultiMarginalMH<B,F>::report(const int c, const S1& s) {
+  int k;
+  double ll = 0.0, rate = 0.0;
+  for (k = 0; k < s.size(); ++k) {
+    ll += s.chains[k]->s1.logLikelihood;
+    rate += (double)accepted[k]/total;
+  }
+  ll /= s.size();
+  rate /= s.size();
+
+  std::cerr << c << ":\t";
+  std::cerr.width(10);
+  std::cerr << ll;
+  std::cerr << "\tchains=" << s.size();
+  std::cerr << "\taccept=" << rate;
+  std::cerr << std::endl;
+}
+
+template<class B, class F>
+void bi::MultiMarginalMH<B,F>::term() {
+  mh.term();
+}
+
+#endif
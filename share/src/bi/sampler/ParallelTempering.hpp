@@ -0,0 +1,384 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_SAMPLER_PARALLELTEMPERING_HPP
+#define BI_SAMPLER_PARALLELTEMPERING_HPP
+
+#include "MarginalMH.hpp"
+
+#include "boost/shared_ptr.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * Parallel tempering (population) marginal Metropolis-Hastings.
+ *
+ * @ingroup method_sampler
+ *
+ * @tparam B Model type
+ * @tparam F Filter type.
+ *
+ * Runs a population of MarginalMH chains, where chain @c k targets the
+ * posterior with likelihood tempered by inverse temperature
+ * \f$\beta_k = T^{-k/(K-1)}\f$, for maximum temperature \f$T\f$ and @c K
+ * chains, so that chain zero is the cold chain that targets the posterior
+ * itself. The chains take their steps concurrently, one per thread, after
+ * which exchanges between adjacent temperatures are proposed, alternating
+ * between even and odd pairs on successive steps. Only the cold chain is
+ * output.
+ *
+ * The chains share the filter, forcer and observer. The caches of the latter
+ * are populated while the chains are initialised one at a time, after which
+ * they are only read, so that the chains may then run concurrently. The
+ * filter itself must have no other mutable state; this excludes the adaptive
+ * particle filter.
+ */
+template<class B, class F>
+class ParallelTempering {
+public:
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param filter Filter.
+   * @param maxTemperature Temperature of the hottest chain.
+   * @param rho Correlation, see MarginalMH.
+   */
+  ParallelTempering(B& m, F& filter, const double maxTemperature = 10.0,
+      const double rho = 0.0);
+
+  /**
+   * @name High-level interface
+   *
+   * An easier interface for common usage.
+   */
+  //@{
+  /**
+   * Sample.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param s State.
+   * @param C Number of samples to draw.
+   * @param out Output buffer.
+   * @param inInit Initialisation file.
+   */
+  template<class S1, class IO1, class IO2>
+  void sample(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, const int C, IO1& out, IO2& inInit);
+  //@}
+
+  /**
+   * @name Low-level interface
+   *
+   * Largely used by other features of the library or for finer control over
+   * performance and behaviour.
+   */
+  //@{
+  /**
+   * Initialise starting state of all chains.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[out] s State.
+   * @param inInit Initialisation file.
+   * @param k0 Index of the first chain in the whole population.
+   * @param K Number of chains in the whole population, zero for the number
+   * of chains in @p s.
+   */
+  template<class S1, class IO1>
+  void init(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, IO1& inInit, const int k0 = 0,
+      const int K = 0);
+
+  /**
+   * Take one step of all chains, concurrently.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void step(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s);
+
+  /**
+   * Propose exchanges between adjacent chains.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param c Step index. Even pairs are considered on even steps, odd pairs
+   * on odd steps.
+   * @param[in,out] s State.
+   * @param k0 Index of the first chain in the whole population.
+   */
+  template<class S1>
+  void exchange(Random& rng, const int c, S1& s, const int k0 = 0);
+
+  /**
+   * Output cold chain.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param c Index in output file.
+   * @param s State.
+   * @param[in,out] out Output buffer.
+   */
+  template<class S1, class IO1>
+  void output(const int c, const S1& s, IO1& out);
+
+  /**
+   * @copydoc Simulator::outputT()
+   */
+  template<class S1, class IO1>
+  void outputT(const S1& s, IO1& out);
+
+  /**
+   * Report progress on stderr.
+   *
+   * @tparam S1 State type.
+   *
+   * @param c Number of steps taken.
+   * @param s State.
+   */
+  template<class S1>
+  void report(const int c, const S1& s);
+
+  /**
+   * Terminate.
+   */
+  void term();
+  //@}
+
+protected:
+  /**
+   * Inverse temperature of a chain.
+   *
+   * @param k Index of the chain in the whole population.
+   * @param K Number of chains in the whole population.
+   */
+  double inverseTemperature(const int k, const int K) const;
+
+  /**
+   * Log-acceptance ratio of exchange between two chains.
+   *
+   * @param beta1 Inverse temperature of first chain.
+   * @param beta2 Inverse temperature of second chain.
+   * @param ll1 Log-likelihood of first chain.
+   * @param ll2 Log-likelihood of second chain.
+   *
+   * @return Log of the acceptance ratio.
+   */
+  static double logExchangeRatio(const double beta1, const double beta2,
+      const double ll1, const double ll2);
+
+  /**
+   * Model.
+   */
+  B& m;
+
+  /**
+   * Filter.
+   */
+  F& filter;
+
+  /**
+   * Temperature of the hottest chain.
+   */
+  double maxTemperature;
+
+  /**
+   * Correlation.
+   */
+  double rho;
+
+  /**
+   * Sampler for each chain.
+   */
+  std::vector<boost::shared_ptr<MarginalMH<B,F> > > mhs;
+
+  /**
+   * Number of accepted exchanges between each chain and the next.
+   */
+  std::vector<int> exchanges;
+
+  /**
+   * Number of exchanges proposed between each chain and the next.
+   */
+  std::vector<int> proposals;
+};
+}
+
+#include "../misc/TicToc.hpp"
+
+#include <algorithm>
+
+template<class B, class F>
+bi::ParallelTempering<B,F>::ParallelTempering(B& m, F& filter,
+    const double maxTemperature, const double rho) :
+    m(m), filter(filter), maxTemperature(maxTemperature), rho(rho) {
+  /* pre-condition */
+  BI_ASSERT(maxTemperature >= 1.0);
+}
+
+template<class B, class F>
+template<class S1, class IO1, class IO2>
+void bi::ParallelTempering<B,F>::sample(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    const int C, IO1& out, IO2& inInit) {
+  /* pre-condition */
+  BI_ERROR(C > 0);
+
+  TicToc clock;
+  init(rng, first, last, s, inInit);
+  output(0, s, out);
+  for (int c = 1; c < C; ++c) {
+    step(rng, first, last, s);
+    exchange(rng, c, s);
+    report(c, s);
+    output(c, s, out);
+  }
+  s.clock = clock.toc();
+  outputT(s, out);
+  term();
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::ParallelTempering<B,F>::init(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    IO1& inInit, const int k0, const int K) {
+  const int K1 = (K > 0) ? K : s.size();
+  int k;
+
+  mhs.resize(s.size());
+  exchanges.resize(s.size());
+  proposals.resize(s.size());
+  std::fill(exchanges.begin(), exchanges.end(), 0);
+  std::fill(proposals.begin(), proposals.end(), 0);
+
+  /* serially, as this populates the input and observation caches */
+  for (k = 0; k < s.size(); ++k) {
+    mhs[k].reset(new MarginalMH<B,F>(m, filter, rho));
+    mhs[k]->setInverseTemperature(inverseTemperature(k0 + k, K1));
+    mhs[k]->init(rng, first, last, s.select(k).s1, s.select(k).out, inInit);
+  }
+}
+
+template<class B, class F>
+template<class S1>
+void bi::ParallelTempering<B,F>::step(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s) {
+  #pragma omp parallel
+  {
+    int k;
+
+    #pragma omp for
+    for (k = 0; k < s.size(); ++k) {
+      typename S1::chain_type& chain = s.select(k);
+      mhs[k]->propose(rng, first, last, chain.s1, chain.s2, chain.out);
+      mhs[k]->acceptReject(rng, chain.s1, chain.s2, chain.out);
+    }
+  }
+}
+
+template<class B, class F>
+template<class S1>
+void bi::ParallelTempering<B,F>::exchange(Random& rng, const int c, S1& s,
+    const int k0) {
+  double logratio;
+  int k;
+
+  for (k = (k0 + c) % 2; k + 1 < s.size(); k += 2) {
+    logratio = logExchangeRatio(mhs[k]->getInverseTemperature(),
+        mhs[k + 1]->getInverseTemperature(),
+        s.select(k).s1.logLikelihood, s.select(k + 1).s1.logLikelihood);
+    if (bi::log(rng.uniform<double>()) < logratio) {
+      s.select(k).swap(s.select(k + 1));
+      ++exchanges[k];
+    }
+    ++proposals[k];
+  }
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::ParallelTempering<B,F>::output(const int c, const S1& s, IO1& out) {
+  out.write(c, s.chains[0]->s1);
+  if (out.isFull()) {
+    out.flush();
+    out.clear();
+  }
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::ParallelTempering<B,F>::outputT(const S1& s, IO1& out) {
+  out.writeClock(s.clock);
+}
+
+template<class B, class F>
+template<class S1>
+void bi::ParallelTempering<B,F>::report(const int c, const S1& s) {
+  std::cerr << c << ":\t";
+  std::cerr.width(10);
+  std::cerr << s.chains[0]->s1.logLikelihood;
+  std::cerr << '\t';
+  std::cerr.width(10);
+  std::cerr << s.chains[0]->s1.logPrior;
+  std::cerr << "\taccept=" << mhs[0]->getAcceptRate();
+  std::cerr << "\texchange=";
+  for (int k = 0; k + 1 < s.size(); ++k) {
+    if (k > 0) {
+      std::cerr << ',';
+    }
+    std::cerr << (proposals[k] > 0 ? (double)exchanges[k] / proposals[k] : 0.0);
+  }
+  std::cerr << std::endl;
+}
+
+template<class B, class F>
+void bi::ParallelTempering<B,F>::term() {
+  //
+}
+
+template<class B, class F>
+double bi::ParallelTempering<B,F>::inverseTemperature(const int k,
+    const int K) const {
+  if (K > 1) {
+    return bi::pow(maxTemperature, -double(k) / (K - 1));
+  } else {
+    return 1.0;
+  }
+}
+
+template<class B, class F>
+double bi::ParallelTempering<B,F>::logExchangeRatio(const double beta1,
+    const double beta2, const double ll1, const double ll2) {
+  if (!bi::is_finite(ll2)) {
+    return -BI_INF;
+  } else if (!bi::is_finite(ll1)) {
+    return BI_INF;
+  } else {
+    return (beta1 - beta2) * (ll2 - ll1);
+  }
+}
+
+#endif
@@ -7,8 +7,11 @@
 #define BI_SAMPLER_SAMPLERFACTORY_HPP
 
 #include "MarginalMH.hpp"
+#include "MultiMarginalMH.hpp"
+#include "ParallelTempering.hpp"
 #include "MarginalSIR.hpp"
 #include "MarginalSIS.hpp"
+#include "IteratedFiltering.hpp"
 
 #include "boost/shared_ptr.hpp"
 
@@ -25,7 +28,22 @@ public:
    */
   template<class B, class F>
   static boost::shared_ptr<MarginalMH<B,F> > createMarginalMH(B& m,
-      F& filter);
+      F& filter, const double rho = 0.0);
+
+  /**
+   * Create multiple-chain marginal Metropolis--Hastings sampler.
+   */
+  template<class B, class F>
+  static boost::shared_ptr<MultiMarginalMH<B,F> > createMultiMarginalMH(
+      B& m, F& filter, const double rho = 0.0);
+
+  /**
+   * Create parallel tempering sampler.
+   */
+  template<class B, class F>
+  static boost::shared_ptr<ParallelTempering<B,F> > createParallelTempering(
+      B& m, F& filter, const double maxTemperature = 10.0,
+      const double rho = 0.0);
 
   /**
    * Create marginal sequential importance resampling sampler.
@@ -41,14 +59,35 @@ public:
   template<class B, class F, class A, class S>
   static boost::shared_ptr<MarginalSIS<B,F,A,S> > createMarginalSIS(B& m,
       F& filter, A& adapter, S& stopper);
+
+  /**
+   * Create iterated filtering sampler.
+   */
+  template<class B, class F>
+  static boost::shared_ptr<IteratedFiltering<B,F> > createIteratedFiltering(
+      B& m, F& filter, const double cooling = 0.95);
 };
 }
 
 template<class B, class F>
 boost::shared_ptr<bi::MarginalMH<B,F> > bi::SamplerFactory::createMarginalMH(
-    B& m, F& filter) {
+    B& m, F& filter, const double rho) {
   return boost::shared_ptr < MarginalMH<B,F>
-      > (new MarginalMH<B,F>(m, filter));
+      > (new MarginalMH<B,F>(m, filter, rho));
+}
+
+template<class B, class F>
+boost::shared_ptr<bi::MultiMarginalMH<B,F> > bi::SamplerFactory::createMultiMarginalMH(
+    B& m, F& filter, const double rho) {
+  return boost::shared_ptr < MultiMarginalMH<B,F>
+      > (new MultiMarginalMH<B,F>(m, filter, rho));
+}
+
+template<class B, class F>
+boost::shared_ptr<bi::ParallelTempering<B,F> > bi::SamplerFactory::createParallelTempering(
+    B& m, F& filter, const double maxTemperature, const double rho) {
+  return boost::shared_ptr < ParallelTempering<B,F>
+      > (new ParallelTempering<B,F>(m, filter, maxTemperature, rho));
 }
 
 template<class B, class F, class A, class R>
@@ -66,4 +105,11 @@ boost::shared_ptr<bi::MarginalSIS<B,F,A,S> > bi::SamplerFactory::createMarginalS
       > (new MarginalSIS<B,F,A,S>(m, filter, adapter, stopper));
 }
 
+template<class B, class F>
+boost::shared_ptr<bi::IteratedFiltering<B,F> > bi::SamplerFactory::createIteratedFiltering(
+    B& m, F& filter, const double cooling) {
+  return boost::shared_ptr < IteratedFiltering<B,F>
+      > (new IteratedFiltering<B,F>(m, filter, cooling));
+}
+
 #endif
@@ -80,6 +80,26 @@ public:
   void init(Random& rng, const ScheduleElement now, S1& s, IO1& out,
       IO2& inInit);
 
+  /**
+   * Initialise for simulation with given parameters.
+   *
+   * @tparam V1 Vector type.
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param theta Parameters.
+   * @param now Current step in time schedule.
+   * @param[out] s State.
+   * @param out Output file.
+   *
+   * The parameter block is not sampled, and initial values of state
+   * variables are not drawn. The caller draws them, e.g. with
+   * Model::initialSamples(), after setting any state variables on which the
+   * initial block depends.
+   */
+  template<class V1, class S1, class IO1>
+  void init(const V1 theta, const ScheduleElement now, S1& s, IO1& out);
+
   /**
    * Propose new state from existing state.
    *
@@ -331,6 +351,36 @@ void bi::Simulator<B,F,O>::init(Random& rng, const ScheduleElement now, S1& s,
   out.clear();
 }
 
+template<class B, class F, class O>
+template<class V1, class S1, class IO1>
+void bi::Simulator<B,F,O>::init(const V1 theta, const ScheduleElement now,
+    S1& s, IO1& out) {
+  s.clear();
+  s.setTime(now.getTime());
+
+  /* static inputs */
+  in.update0(s);
+
+  /* parameters */
+  row(s.get(P_VAR), 0) = theta;
+
+  /* prior log-density */
+  s.get(PY_VAR) = s.get(P_VAR);
+  s.logPrior = m.parameterLogDensity(s);
+
+  /* dynamic inputs */
+  if (now.hasInput()) {
+    in.update(now.indexInput(), s);
+  }
+
+  /* observations */
+  if (now.hasObs()) {
+    obs.update(now.indexObs(), s);
+  }
+
+  out.clear();
+}
+
 template<class B, class F, class O>
 template<class S1, class S2, class IO1>
 void bi::Simulator<B,F,O>::propose(Random& rng, const ScheduleElement now,
@@ -423,14 +473,17 @@ template<class B, class F, class O>
 template<class S1>
 void bi::Simulator<B,F,O>::predict(Random& rng, const ScheduleElement next,
     S1& s) {
+  s.timer.tic();
   if (next.hasInput()) {
     in.update(next.indexInput(), s);
   }
   if (next.hasObs()) {
     obs.update(next.indexObs(), s);
   }
+  s.timer.toc(PHASE_INPUT);
   m.transitionSamples(rng, next.getFrom(), next.getTo(), next.hasDelta(), s);
   s.setTime(next.getTime());
+  s.timer.toc(PHASE_TRANSITION);
 }
 
 template<class B, class F, class O>
@@ -439,15 +492,18 @@ void bi::Simulator<B,F,O>::lookahead(Random& rng, const ScheduleElement next,
     S1& s) {
   // this implementation is (should be) the same as predict() above, but
   // using m.lookaheadTransitionSamples() rather than m.transitionSamples()
+  s.timer.tic();
   if (next.hasInput()) {
     in.update(next.indexInput(), s);
   }
   if (next.hasObs()) {
     obs.update(next.indexObs(), s);
   }
+  s.timer.toc(PHASE_INPUT);
   m.lookaheadTransitionSamples(rng, next.getFrom(), next.getTo(),
       next.hasDelta(), s);
   s.setTime(next.getTime());
+  s.timer.toc(PHASE_TRANSITION);
 }
 
 template<class B, class F, class O>
@@ -467,7 +523,9 @@ template<class S1, class IO1>
 void bi::Simulator<B,F,O>::output(const ScheduleElement now, const S1& s,
     IO1& out) {
   if (now.hasOutput()) {
+    s.timer.tic();
     out.write(now.indexOutput(), now.getTime(), s);
+    s.timer.toc(PHASE_OUTPUT);
   }
 }
 
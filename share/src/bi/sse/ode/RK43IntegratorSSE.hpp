@@ -47,7 +47,7 @@ void bi::RK43IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
     int n, id, p;
     PX pax;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; p += BI_SIMD_SIZE) {
       t = t1;
       h = h_h0;
@@ -46,7 +46,7 @@ void bi::RK4IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
     int p;
     PX pax;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < P; p += BI_SIMD_SIZE) {
       t = t1;
       h = h_h0;
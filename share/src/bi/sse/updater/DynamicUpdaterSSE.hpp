@@ -54,7 +54,7 @@ void bi::DynamicUpdaterSSE<B,S>::update(const T1 t1, const T1 t2,
     PX pax;
     OX x;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
       Visitor::accept(t1, t2, s, p, pax, x);
     }
@@ -54,7 +54,7 @@ void bi::SparseStaticLogDensitySSE<B,S>::logDensities(State<B,ON_HOST>& s,
     OX x;
     simd_real* lp1;
 
-    #pragma omp for
+    #pragma omp for schedule(static)
     for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
       lp1 = reinterpret_cast<simd_real*>(&lp(p));
       Visitor::accept(mask, s, p, pax, x, *lp1);
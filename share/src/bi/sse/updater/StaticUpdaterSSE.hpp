@@ -46,7 +46,7 @@ void bi::StaticUpdaterSSE<B,S>::update(State<B,ON_HOST>& s) {
     PX pax;
     OX x;
 
-#pragma omp for
+#pragma omp for schedule(static)
     for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
       Visitor::accept(s, p, pax, x);
     }
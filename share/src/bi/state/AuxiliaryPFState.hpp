@@ -70,7 +70,8 @@ public:
    * @copydoc BootstrapPFState::gather()
    */
   template<class V1>
-  void gather(const ScheduleElement now, const V1 as);
+  void gather(const ScheduleElement now, const V1 as, const bool permuted =
+      true);
 
 private:
   /**
@@ -157,10 +158,16 @@ inline void bi::AuxiliaryPFState<B,L>::resizeMax(const int maxP,
 template<class B, bi::Location L>
 template<class V1>
 void bi::AuxiliaryPFState<B,L>::gather(const ScheduleElement now,
-    const V1 as) {
-  BootstrapPFState<B,L>::gather(now, as);
+    const V1 as, const bool permuted) {
+  BootstrapPFState<B,L>::gather(now, as, permuted);
   if (!now.hasOutput()) {
-    bi::gather(as, logAuxWeights(), logAuxWeights());
+    if (permuted) {
+      bi::gather(as, logAuxWeights(), logAuxWeights());
+    } else {
+      typename State<B,L>::temp_vector_type lqs(logAuxWeights().size());
+      lqs = logAuxWeights();
+      bi::gather(as, lqs, logAuxWeights());
+    }
   }
 }
 
@@ -83,9 +83,11 @@ public:
    *
    * @param now Current step in time schedule.
    * @param as Ancestry.
+   * @param permuted Is @p as permuted? See State::gather().
    */
   template<class V1>
-  void gather(const ScheduleElement now, const V1 as);
+  void gather(const ScheduleElement now, const V1 as, const bool permuted =
+      true);
 
   /**
    * Last ESS.
@@ -202,12 +204,16 @@ inline void bi::BootstrapPFState<B,L>::resizeMax(const int maxP,
 template<class B, bi::Location L>
 template<class V1>
 void bi::BootstrapPFState<B,L>::gather(const ScheduleElement now,
-    const V1 as) {
-  FilterState<B,L>::gather(as);
+    const V1 as, const bool permuted) {
+  FilterState<B,L>::gather(as, permuted);
   if (now.hasOutput()) {
     ancestors() = as;
-  } else {
+  } else if (permuted) {
     bi::gather(as, ancestors(), ancestors());
+  } else {
+    typename State<B,L>::temp_int_vector_type as1(ancestors().size());
+    as1 = ancestors();
+    bi::gather(as, as1, ancestors());
   }
 }
 
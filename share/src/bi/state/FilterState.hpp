@@ -7,6 +7,7 @@
 #define BI_STATE_FILTERSTATE_HPP
 
 #include "State.hpp"
+#include "../math/function.hpp"
 
 namespace bi {
 /**
@@ -46,6 +47,19 @@ public:
    */
   void swap(FilterState<B,L>& o);
 
+  /**
+   * Extend to a longer time schedule, preserving existing contents.
+   *
+   * @param Y Number of observation times.
+   * @param T Number of output times.
+   *
+   * Used to resume filtering when observations arrive incrementally, see
+   * Filter::resume(). Storage is at least doubled whenever it must grow, so
+   * that the cost of repeated extension is amortised, and may be larger
+   * than requested.
+   */
+  void extend(const int Y, const int T);
+
   /**
    * Path sample.
    */
@@ -66,6 +80,14 @@ public:
    */
   double logLikelihood;
 
+  /**
+   * Seeds of the random number streams used for each block of the schedule
+   * (the initial state, the correction at the start time, then each step
+   * between observations). Used by correlated pseudo-marginal methods to
+   * replay the same random numbers.
+   */
+  host_vector<int> seeds;
+
 private:
   /**
    * Serialize.
@@ -90,14 +112,14 @@ private:
 template<class B, bi::Location L>
 bi::FilterState<B,L>::FilterState(const int P, const int Y, const int T) :
     State<B,L>(P, Y, T), path(B::NR + B::ND, T), times(T), logIncrements(Y), logLikelihood(
-        0.0) {
+        0.0), seeds(Y + 3) {
   //
 }
 
 template<class B, bi::Location L>
 bi::FilterState<B,L>::FilterState(const FilterState<B,L>& o) :
     State<B,L>(o), path(o.path), times(o.times), logIncrements(
-        o.logIncrements), logLikelihood(o.logLikelihood) {
+        o.logIncrements), logLikelihood(o.logLikelihood), seeds(o.seeds) {
   //
 }
 
@@ -109,6 +131,7 @@ bi::FilterState<B,L>& bi::FilterState<B,L>::operator=(
   times = o.times;
   logIncrements = o.logIncrements;
   logLikelihood = o.logLikelihood;
+  seeds = o.seeds;
 
   return *this;
 }
@@ -129,6 +152,25 @@ void bi::FilterState<B,L>::swap(FilterState<B,L>& o) {
   times.swap(o.times);
   logIncrements.swap(o.logIncrements);
   std::swap(logLikelihood, o.logLikelihood);
+  seeds.swap(o.seeds);
+}
+
+template<class B, bi::Location L>
+void bi::FilterState<B,L>::extend(const int Y, const int T) {
+  /* pre-conditions */
+  BI_ASSERT(Y >= 0);
+  BI_ASSERT(T >= 0);
+
+  if (T > times.size()) {
+    const int T1 = bi::max(T, 2 * static_cast<int>(times.size()));
+    path.resize(path.size1(), T1, true);
+    times.resize(T1, true);
+  }
+  if (Y > logIncrements.size()) {
+    const int Y1 = bi::max(Y, 2 * static_cast<int>(logIncrements.size()));
+    logIncrements.resize(Y1, true);
+    seeds.resize(Y1 + 3, true);
+  }
 }
 
 template<class B, bi::Location L>
@@ -139,6 +181,7 @@ void bi::FilterState<B,L>::save(Archive& ar, const unsigned version) const {
   save_resizable_vector(ar, version, times);
   save_resizable_vector(ar, version, logIncrements);
   ar & logLikelihood;
+  save_resizable_vector(ar, version, seeds);
 }
 
 template<class B, bi::Location L>
@@ -149,6 +192,7 @@ void bi::FilterState<B,L>::load(Archive& ar, const unsigned version) {
   load_resizable_vector(ar, version, times);
   load_resizable_vector(ar, version, logIncrements);
   ar & logLikelihood;
+  load_resizable_vector(ar, version, seeds);
 }
 
 #endif
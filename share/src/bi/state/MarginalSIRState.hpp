@@ -7,6 +7,7 @@
 #define BI_STATE_MARGINALSIRSTATE_HPP
 
 #include "ScheduleElement.hpp"
+#include "../misc/omp.hpp"
 
 #include <vector>
 
@@ -45,6 +46,9 @@ public:
   typedef typename loc_temp_vector<L,int_value_type>::type temp_int_vector_type;
   typedef typename loc_temp_matrix<L,int_value_type>::type temp_int_matrix_type;
 
+  typedef S1 filter_state_type;
+  typedef IO1 filter_output_type;
+
   /**
    * Constructor.
    *
@@ -124,14 +128,14 @@ public:
   std::vector<IO1*> out1s;
 
   /**
-   * Proposed state.
+   * Proposed states, one for each thread.
    */
-  S1 s2;
+  std::vector<S1*> s2s;
 
   /**
-   * Proposed output.
+   * Proposed outputs, one for each thread.
    */
-  IO1 out2;
+  std::vector<IO1*> out2s;
 
   /**
    * Marginal log-likelihood increments.
@@ -197,25 +201,35 @@ private:
 template<class B, bi::Location L, class S1, class IO1>
 bi::MarginalSIRState<B,L,S1,IO1>::MarginalSIRState(B& m, const int Ptheta,
     const int Px, const int Y, const int T) :
-    s1s(Ptheta), out1s(Ptheta), s2(Px, Y, T), out2(m, Px, T), logIncrements(Y), logLikelihood(
+    s1s(Ptheta), out1s(Ptheta), s2s(bi_omp_max_threads), out2s(
+        bi_omp_max_threads), logIncrements(Y), logLikelihood(
         0.0), ess(0.0), lws(Ptheta), as(Ptheta), ptheta(0), Ptheta(
         Ptheta) {
   for (int p = 0; p < size(); ++p) {
     s1s[p] = new S1(Px, Y, T);
     out1s[p] = new IO1(m, Px, T);
   }
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    s2s[k] = new S1(Px, Y, T);
+    out2s[k] = new IO1(m, Px, T);
+  }
 }
 
 template<class B, bi::Location L, class S1, class IO1>
 bi::MarginalSIRState<B,L,S1,IO1>::MarginalSIRState(
     const MarginalSIRState<B,L,S1,IO1>& o) :
-    s1s(o.s1s.size()), out1s(o.out1s.size()), s2(o.s2), out2(o.out2), logIncrements(o.logIncrements), logLikelihood(
+    s1s(o.s1s.size()), out1s(o.out1s.size()), s2s(o.s2s.size()), out2s(
+        o.out2s.size()), logIncrements(o.logIncrements), logLikelihood(
         o.logLikelihood), ess(0.0), lws(o.lws), as(
         o.as), ptheta(o.ptheta), Ptheta(o.Ptheta) {
   for (int p = 0; p < size(); ++p) {
     s1s[p] = new S1(*o.s1s[p]);
     out1s[p] = new IO1(*o.out1s[p]);
   }
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    s2s[k] = new S1(*o.s2s[k]);
+    out2s[k] = new IO1(*o.out2s[k]);
+  }
 }
 
 template<class B, bi::Location L, class S1, class IO1>
@@ -228,8 +242,10 @@ bi::MarginalSIRState<B,L,S1,IO1>& bi::MarginalSIRState<B,L,S1,IO1>::operator=(
     *s1s[p] = *o.s1s[p];
     *out1s[p] = *o.out1s[p];
   }
-  s2 = o.s2;
-  out2 = o.out2;
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    *s2s[k] = *o.s2s[k];
+    *out2s[k] = *o.out2s[k];
+  }
   logIncrements = o.logIncrements;
   logLikelihood = o.logLikelihood;
   ess = o.ess;
@@ -247,8 +263,10 @@ void bi::MarginalSIRState<B,L,S1,IO1>::clear() {
     s1s[p]->clear();
     out1s[p]->clear();
   }
-  s2.clear();
-  out2.clear();
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    s2s[k]->clear();
+    out2s[k]->clear();
+  }
   logIncrements.clear();
   logLikelihood = 0.0;
   ess = 0.0;
@@ -260,8 +278,8 @@ template<class B, bi::Location L, class S1, class IO1>
 void bi::MarginalSIRState<B,L,S1,IO1>::swap(MarginalSIRState<B,L,S1,IO1>& o) {
   std::swap(s1s, o.s1s);
   std::swap(out1s, o.out1s);
-  s2.swap(o.s2);
-  out2.swap(o.out2);
+  std::swap(s2s, o.s2s);
+  std::swap(out2s, o.out2s);
   logIncrements.swap(o.logIncrements);
   std::swap(logLikelihood, o.logLikelihood);
   std::swap(ess, o.ess);
@@ -336,8 +354,10 @@ void bi::MarginalSIRState<B,L,S1,IO1>::save(Archive& ar,
     ar & *s1s[p];
     ar & *out1s[p];
   }
-  ar & s2;
-  ar & out2;
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    ar & *s2s[k];
+    ar & *out2s[k];
+  }
   save_resizable_vector(ar, version, logIncrements);
   ar & logLikelihood;
   ar & ess;
@@ -355,8 +375,10 @@ void bi::MarginalSIRState<B,L,S1,IO1>::load(Archive& ar,
     ar & *s1s[p];
     ar & *out1s[p];
   }
-  ar & s2;
-  ar & out2;
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    ar & *s2s[k];
+    ar & *out2s[k];
+  }
   load_resizable_vector(ar, version, logIncrements);
   ar & logLikelihood;
   ar & ess;
@@ -0,0 +1,189 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_STATE_MULTIMARGINALMHSTATE_HPP
+#define BI_STATE_MULTIMARGINALMHSTATE_HPP
+
+#include "MarginalMHState.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * State for MultiMarginalMH.
+ *
+ * @ingroup state
+ *
+ * @tparam B Model type.
+ * @tparam L Location.
+ * @tparam S1 Filter state type.
+ * @tparam IO1 Filter cache type.
+ */
+template<class B, Location L, class S1, class IO1>
+class MultiMarginalMHState {
+public:
+  typedef MarginalMHState<B,L,S1,IO1> chain_type;
+
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param K Number of chains.
+   * @param P Number of \f$x\f$-particles.
+   * @param Y Number of observation times.
+   * @param T Number of output times.
+   */
+  MultiMarginalMHState(B& m, const int K = 1, const int P = 0, const int Y =
+      0, const int T = 0);
+
+  /**
+   * Deep copy constructor.
+   */
+  MultiMarginalMHState(const MultiMarginalMHState<B,L,S1,IO1>& o);
+
+  /**
+   * Destructor.
+   */
+  ~MultiMarginalMHState();
+
+  /**
+   * Deep assignment operator.
+   */
+  MultiMarginalMHState& operator=(const MultiMarginalMHState<B,L,S1,IO1>& o);
+
+  /**
+   * Clear.
+   */
+  void clear();
+
+  /**
+   * Swap.
+   */
+  void swap(MultiMarginalMHState<B,L,S1,IO1>& o);
+
+  /**
+   * Number of chains.
+   */
+  int size() const;
+
+  /**
+   * Select single chain.
+   */
+  chain_type& select(const int k);
+
+  /**
+   * Chains.
+   */
+  std::vector<chain_type*> chains;
+
+  /**
+   * Execution time.
+   */
+  long clock;
+
+private:
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
+};
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+bi::MultiMarginalMHState<B,L,S1,IO1>::MultiMarginalMHState(B& m, const int K,
+    const int P, const int Y, const int T) :
+    chains(K), clock(0) {
+  for (int k = 0; k < size(); ++k) {
+    chains[k] = new chain_type(m, P, Y, T);
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+bi::MultiMarginalMHState<B,L,S1,IO1>::MultiMarginalMHState(
+    const MultiMarginalMHState<B,L,S1,IO1>& o) :
+    chains(o.chains.size()), clock(o.clock) {
+  for (int k = 0; k < size(); ++k) {
+    chains[k] = new chain_type(*o.chains[k]);
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+bi::MultiMarginalMHState<B,L,S1,IO1>::~MultiMarginalMHState() {
+  for (int k = 0; k < size(); ++k) {
+    delete chains[k];
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+bi::MultiMarginalMHState<B,L,S1,IO1>& bi::MultiMarginalMHState<B,L,S1,IO1>::operator=(
+    const MultiMarginalMHState<B,L,S1,IO1>& o) {
+  /* pre-condition */
+  BI_ASSERT(o.size() == size());
+
+  for (int k = 0; k < size(); ++k) {
+    *chains[k] = *o.chains[k];
+  }
+  clock = o.clock;
+
+  return *this;
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+void bi::MultiMarginalMHState<B,L,S1,IO1>::clear() {
+  for (int k = 0; k < size(); ++k) {
+    chains[k]->clear();
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+void bi::MultiMarginalMHState<B,L,S1,IO1>::swap(
+    MultiMarginalMHState<B,L,S1,IO1>& o) {
+  std::swap(chains, o.chains);
+  std::swap(clock, o.clock);
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+int bi::MultiMarginalMHState<B,L,S1,IO1>::size() const {
+  return chains.size();
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+typename bi::MultiMarginalMHState<B,L,S1,IO1>::chain_type& bi::MultiMarginalMHState<
+    B,L,S1,IO1>::select(const int k) {
+  return *chains[k];
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+template<class Archive>
+void bi::MultiMarginalMHState<B,L,S1,IO1>::save(Archive& ar,
+    const unsigned version) const {
+  for (int k = 0; k < size(); ++k) {
+    ar & *chains[k];
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+template<class Archive>
+void bi::MultiMarginalMHState<B,L,S1,IO1>::load(Archive& ar,
+    const unsigned version) {
+  for (int k = 0; k < size(); ++k) {
+    ar & *chains[k];
+  }
+}
+
+#endif
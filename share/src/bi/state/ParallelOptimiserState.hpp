@@ -0,0 +1,184 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ */
+#ifndef BI_STATE_PARALLELOPTIMISERSTATE_HPP
+#define BI_STATE_PARALLELOPTIMISERSTATE_HPP
+
+#include "../misc/omp.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * State for ParallelNelderMeadOptimiser.
+ *
+ * @ingroup state
+ *
+ * @tparam B Model type.
+ * @tparam L Location.
+ * @tparam S Filter state type.
+ * @tparam IO1 Filter cache type.
+ *
+ * In addition to the state and output of OptimiserState, holds one filter
+ * state and output per thread, so that the objective may be evaluated at
+ * several points concurrently.
+ */
+template<class B, Location L, class S, class IO1>
+class ParallelOptimiserState {
+public:
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param P Number of \f$x\f$-particles.
+   * @param Y Number of observation times.
+   * @param T Number of output times.
+   */
+  ParallelOptimiserState(B& m, const int P = 0, const int Y = 0,
+      const int T = 0);
+
+  /**
+   * Deep copy constructor.
+   */
+  ParallelOptimiserState(const ParallelOptimiserState<B,L,S,IO1>& o);
+
+  /**
+   * Destructor.
+   */
+  ~ParallelOptimiserState();
+
+  /**
+   * Assignment operator.
+   */
+  ParallelOptimiserState& operator=(
+      const ParallelOptimiserState<B,L,S,IO1>& o);
+
+  /**
+   * Clear.
+   */
+  void clear();
+
+  /**
+   * Current state.
+   */
+  S s;
+
+  /**
+   * Filter output.
+   */
+  IO1 out;
+
+  /**
+   * Filter states for evaluations, indexed by thread.
+   */
+  std::vector<S*> s2s;
+
+  /**
+   * Filter outputs for evaluations, indexed by thread.
+   */
+  std::vector<IO1*> out2s;
+
+  /**
+   * Execution time.
+   */
+  long clock;
+
+private:
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
+};
+}
+
+template<class B, bi::Location L, class S, class IO1>
+bi::ParallelOptimiserState<B,L,S,IO1>::ParallelOptimiserState(B& m,
+    const int P, const int Y, const int T) :
+    s(P, Y, T), out(m, P, T), s2s(bi_omp_max_threads), out2s(
+        bi_omp_max_threads), clock(0) {
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    s2s[k] = new S(P, Y, T);
+    out2s[k] = new IO1(m, P, T);
+  }
+}
+
+template<class B, bi::Location L, class S, class IO1>
+bi::ParallelOptimiserState<B,L,S,IO1>::ParallelOptimiserState(
+    const ParallelOptimiserState<B,L,S,IO1>& o) :
+    s(o.s), out(o.out), s2s(o.s2s.size()), out2s(o.out2s.size()), clock(
+        o.clock) {
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    s2s[k] = new S(*o.s2s[k]);
+    out2s[k] = new IO1(*o.out2s[k]);
+  }
+}
+
+template<class B, bi::Location L, class S, class IO1>
+bi::ParallelOptimiserState<B,L,S,IO1>::~ParallelOptimiserState() {
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    delete s2s[k];
+    delete out2s[k];
+  }
+}
+
+template<class B, bi::Location L, class S, class IO1>
+bi::ParallelOptimiserState<B,L,S,IO1>& bi::ParallelOptimiserState<B,L,S,IO1>::operator=(
+    const ParallelOptimiserState<B,L,S,IO1>& o) {
+  /* pre-condition */
+  BI_ASSERT(o.s2s.size() == s2s.size());
+
+  s = o.s;
+  out = o.out;
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    *s2s[k] = *o.s2s[k];
+    *out2s[k] = *o.out2s[k];
+  }
+  clock = o.clock;
+
+  return *this;
+}
+
+template<class B, bi::Location L, class S, class IO1>
+void bi::ParallelOptimiserState<B,L,S,IO1>::clear() {
+  s.clear();
+  out.clear();
+  for (int k = 0; k < (int)s2s.size(); ++k) {
+    s2s[k]->clear();
+    out2s[k]->clear();
+  }
+}
+
+template<class B, bi::Location L, class S, class IO1>
+template<class Archive>
+void bi::ParallelOptimiserState<B,L,S,IO1>::save(Archive& ar,
+    const unsigned version) const {
+  ar & s;
+  ar & out;
+  ar & clock;
+}
+
+template<class B, bi::Location L, class S, class IO1>
+template<class Archive>
+void bi::ParallelOptimiserState<B,L,S,IO1>::load(Archive& ar,
+    const unsigned version) {
+  ar & s;
+  ar & out;
+  ar & clock;
+}
+
+#endif
@@ -135,6 +135,29 @@ public:
    */
   Schedule& operator=(const Schedule& o);
 
+  /**
+   * Extend the schedule to a later end time.
+   *
+   * @tparam IO1 Input type.
+   * @tparam IO2 Input type.
+   *
+   * @param T New end time.
+   * @param in Input file.
+   * @param obs Observation file.
+   * @param outputAtObs Output at all observation times as well as at the
+   * end time?
+   *
+   * Events in the half-open interval between the current and new end
+   * times are appended, with indices continuing from the current end, so
+   * that iterators into the schedule are invalidated but indices are not.
+   * Only input and observation times after those already in the schedule
+   * are read. No dense output or bridge points are added, only those at
+   * the new end time.
+   */
+  template<class IO1, class IO2>
+  void extend(const real T, IO1& in, IO2& obs, const bool outputAtObs =
+      true);
+
   /**
    * Number of unique times in the schedule.
    */
@@ -336,6 +359,127 @@ bi::Schedule::Schedule(B& m, const real t, const real T, const int K,
   elems.push_back(elem);  // see end() semantics for why this extra
 }
 
+template<class IO1, class IO2>
+void bi::Schedule::extend(const real T, IO1& in, IO2& obs,
+    const bool outputAtObs) {
+  /* pre-condition */
+  BI_ASSERT(T >= elems.back().getTime());
+
+  User2Scaled<real> user2scaled(delta);
+  Scaled2User<real> scaled2user(delta);
+
+  ScheduleElement elem = elems.back();
+  elems.pop_back();  // end marker, replaced below
+
+  const real s0 = user2scaled(elem.t2), sT = user2scaled(T);
+  std::vector<real> ts, tDeltas, tInputs, tOutputs, tBridges, tObs;
+  real prev, t;
+  int i, iDelta = 0, iInput = 0, iOutput = 0, iBridge = 0, iObs = 0;
+  size_t k;
+
+  /* delta times, including the current end time, as a delta event is
+   * raised on the step after its time */
+  i = static_cast<int>(bi::floor(s0));
+  if (i < s0) {
+    ++i;
+  }
+  while (i <= sT) {
+    tDeltas.push_back(i);
+    ++i;
+  }
+
+  /* output and bridge times */
+  tOutputs.push_back(sT);
+  tBridges.push_back(sT);
+
+  /* input times, from the first not already in the schedule */
+  for (k = elem.kInput; k < in.numTimes(); ++k) {
+    t = user2scaled(in.getTime(k));
+    if (t > sT) {
+      break;
+    } else if (t > s0) {
+      tInputs.push_back(t);
+    } else {
+      ++elem.kInput;
+    }
+  }
+  merge_unique(ts, tInputs.begin(), tInputs.end());
+
+  /* observation times, from the first not already in the schedule */
+  for (k = elem.kObs; k < obs.numTimes(); ++k) {
+    t = user2scaled(obs.getTime(k));
+    if (t > sT) {
+      break;
+    } else if (t > s0) {
+      tObs.push_back(t);
+    } else {
+      ++elem.kObs;
+    }
+  }
+  if (outputAtObs) {
+    merge_unique(tOutputs, tObs.begin(), tObs.end());
+  } else {
+    merge_unique(ts, tObs.begin(), tObs.end());
+  }
+
+  /* combination of all (unique) times */
+  merge_unique(ts, tDeltas.begin(), tDeltas.end());
+  merge_unique(ts, tOutputs.begin(), tOutputs.end());
+  merge_unique(ts, tBridges.begin(), tBridges.end());
+  ts.erase(ts.begin(), std::upper_bound(ts.begin(), ts.end(), s0));
+
+  /* extend schedule, as in the constructor, but with the current end time
+   * as the time before the first new event */
+  prev = s0;
+  for (k = 0; k < ts.size(); ++k) {
+    elem.t1 = elem.t2;
+    elem.t2 = scaled2user(ts[k]);
+    elem.bDelta = iDelta < int(tDeltas.size()) && tDeltas[iDelta] == prev;
+    elem.bInput = iInput < int(tInputs.size()) && tInputs[iInput] == ts[k];
+    elem.bOutput = iOutput < int(tOutputs.size())
+        && tOutputs[iOutput] == ts[k];
+    elem.bBridge = iBridge < int(tBridges.size())
+        && tBridges[iBridge] == ts[k];
+    elem.bObs = iObs < int(tObs.size())
+        && ((iObs > 0 && tObs[iObs - 1] == prev)
+            || (iObs == 0 && elem.kObs > 0
+                && user2scaled(obs.getTime(elem.kObs - 1)) == prev));
+    elem.bObserved = iObs < int(tObs.size()) && tObs[iObs] == ts[k];
+
+    elems.push_back(elem);
+
+    if (elem.bDelta) {
+      ++elem.kDelta;
+      ++iDelta;
+    }
+    if (elem.bInput) {
+      ++elem.kInput;
+      ++iInput;
+    }
+    if (elem.bOutput) {
+      ++elem.kOutput;
+      ++iOutput;
+    }
+    if (elem.bBridge) {
+      ++elem.kBridge;
+      ++iBridge;
+    }
+    if (elem.bObserved) {
+      ++elem.kObs;
+      ++iObs;
+    }
+    ++elem.k;
+    prev = ts[k];
+  }
+  elem.t1 = elem.t2;
+  elem.bDelta = false;
+  elem.bInput = false;
+  elem.bOutput = false;
+  elem.bBridge = false;
+  elem.bObs = false;
+  elems.push_back(elem);  // see end() semantics for why this extra
+}
+
 inline int bi::Schedule::numTimes() const {
   return elems.back().indexTime() - elems.front().indexTime();
 }
@@ -12,6 +12,7 @@
 #include "../math/loc_matrix.hpp"
 #include "../math/loc_temp_vector.hpp"
 #include "../math/loc_temp_matrix.hpp"
+#include "../misc/PhaseTimer.hpp"
 
 #include "boost/serialization/split_member.hpp"
 
@@ -171,7 +172,8 @@ public:
    *
    * Resizes the state to store at least @p maxP number of trajectories.
    * This affects the maximum size (see #sizeMax), and if this size is
-   * reduced, may truncate the active range.
+   * reduced, may truncate the active range. New storage is first touched by
+   * the threads that own each trajectory (see clear_rows()).
    */
   void resizeMax(const int maxP, const bool preserve = true);
 
@@ -191,9 +193,12 @@ public:
    * @tparam V1 Vector type.
    *
    * @param as Ancestry.
+   * @param permuted Is @p as permuted, so that each particle with offspring
+   * is its own first offspring? If so, the gather is made in place,
+   * otherwise through a temporary copy.
    */
   template<class V1>
-  void gather(const V1 as);
+  void gather(const V1 as, const bool permuted = true);
 
   /**
    * @name Built-in variables
@@ -404,6 +409,12 @@ public:
    */
   long clock;
 
+  /**
+   * Execution time by phase. Mutable so that time spent writing output
+   * may be attributed against a const state.
+   */
+  mutable PhaseTimer timer;
+
 protected:
   /* net sizes, for convenience */
   static const int NR = B::NR;
@@ -480,8 +491,8 @@ bi::State<B,L>::State(const int P, const int Y, const int T) :
 
 template<class B, bi::Location L>
 bi::State<B,L>::State(const State<B,L>& o) :
-    logPrior(o.logPrior), logProposal(o.logProposal), clock(o.clock), Xdn(
-        o.Xdn), Kdn(o.Kdn), p(o.p), P(o.P) {
+    logPrior(o.logPrior), logProposal(o.logProposal), clock(o.clock), timer(
+        o.timer), Xdn(o.Xdn), Kdn(o.Kdn), p(o.p), P(o.P) {
   for (int i = 0; i < NB; ++i) {
     builtin[i] = o.builtin[i];
   }
@@ -492,6 +503,7 @@ bi::State<B,L>& bi::State<B,L>::operator=(const State<B,L>& o) {
   logPrior = o.logPrior;
   logProposal = o.logProposal;
   clock = o.clock;
+  timer = o.timer;
   rows(Xdn, p, P) = rows(o.Xdn, o.p, o.P);
   Kdn = o.Kdn;
   for (int i = 0; i < NB; ++i) {
@@ -506,6 +518,7 @@ bi::State<B,L>& bi::State<B,L>::operator=(const State<B,L2>& o) {
   logPrior = o.logPrior;
   logProposal = o.logProposal;
   clock = o.clock;
+  timer = o.timer;
   rows(Xdn, p, P) = rows(o.Xdn, o.p, o.P);
   Kdn = o.Kdn;
   for (int i = 0; i < NB; ++i) {
@@ -519,6 +532,7 @@ void bi::State<B,L>::swap(State<B,L>& o) {
   std::swap(logPrior, o.logPrior);
   std::swap(logProposal, o.logProposal);
   std::swap(clock, o.clock);
+  timer.swap(o.timer);
   Xdn.swap(o.Xdn);
   Kdn.swap(o.Kdn);
   for (int i = 0; i < NB; ++i) {
@@ -563,7 +577,17 @@ inline void bi::State<B,L>::resizeMax(const int maxP, const bool preserve) {
   /* pre-condition */
   BI_ASSERT(maxP == roundup(maxP));
 
-  Xdn.resize(maxP, Xdn.size2(), preserve);
+  if (maxP != Xdn.size1()) {
+    /* first touch of new storage by the threads that own each particle,
+     * before any copy of preserved values */
+    matrix_type X(maxP, Xdn.size2());
+    clear_rows(X);
+    if (preserve) {
+      const int n = bi::min(maxP, (int)Xdn.size1());
+      rows(X, 0, n) = rows(Xdn, 0, n);
+    }
+    Xdn.swap(X);
+  }
   if (p > maxP) {
     p = maxP;
   }
@@ -577,7 +601,8 @@ inline void bi::State<B,L>::clear() {
   logPrior = -BI_INF;
   logProposal = -BI_INF;
   clock = 0;
-  rows(Xdn, p, P).clear();
+  timer.reset();
+  clear_rows(rows(Xdn, p, P));
   Kdn.clear();
 }
 
@@ -904,8 +929,14 @@ typename bi::State<B,L>::vector_reference_type bi::State<B,L>::select(
 
 template<class B, bi::Location L>
 template<class V1>
-void bi::State<B,L>::gather(const V1 as) {
-  bi::gather_rows(as, getDyn(), getDyn());
+void bi::State<B,L>::gather(const V1 as, const bool permuted) {
+  if (permuted) {
+    bi::gather_rows(as, getDyn(), getDyn());
+  } else {
+    temp_matrix_type X(getDyn().size1(), getDyn().size2());
+    X = getDyn();
+    bi::gather_rows(as, X, getDyn());
+  }
 }
 
 template<class B, bi::Location L>
@@ -914,6 +945,7 @@ void bi::State<B,L>::save(Archive& ar, const unsigned version) const {
   ar & logPrior;
   ar & logProposal;
   ar & clock;
+  ar & timer;
   save_resizable_matrix(ar, version, Xdn);
   save_resizable_matrix(ar, version, Kdn);
   ar & builtin;
@@ -927,6 +959,7 @@ void bi::State<B,L>::load(Archive& ar, const unsigned version) {
   ar & logPrior;
   ar & logProposal;
   ar & clock;
+  ar & timer;
   load_resizable_matrix(ar, version, Xdn);
   load_resizable_matrix(ar, version, Kdn);
   ar & builtin;